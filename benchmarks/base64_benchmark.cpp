@@ -0,0 +1,101 @@
+#include "legacy_base64.h"
+#include <SimpleBase64.h>
+#include <benchmark/benchmark.h>
+#include <random>
+
+/**
+ * @file base64_benchmark.cpp
+ * @brief SimpleBase64 与旧实现的编解码吞吐量对比
+ *
+ * @code
+ * cmake -B build -DLAB2QRCODE_BUILD_BENCHMARKS=ON && cmake --build build --target base64_benchmark
+ * ./base64_benchmark --benchmark_filter=Decode
+ * @endcode
+ */
+
+namespace {
+
+std::vector<std::uint8_t> randomBytes(std::size_t len) {
+    std::mt19937 rng(42);
+    std::vector<std::uint8_t> data(len);
+    for (auto &b : data) {
+        b = static_cast<std::uint8_t>(rng());
+    }
+    return data;
+}
+
+void sizes(benchmark::internal::Benchmark *b) {
+    // 单个条码的容量、典型化验文件、大文件
+    b->Arg(2 << 10)->Arg(256 << 10)->Arg(16 << 20);
+}
+
+void BM_EncodeLegacy(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LegacyBase64::encode(data.data(), data.size()));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Encode(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SimpleBase64::encode(data));
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_EncodeScalar(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    std::string out((data.size() + 2) / 3 * 4, '\0');
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SimpleBase64::detail::encode_blocks_scalar(data.data(), data.size(), out.data()));
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_EncodeStreaming(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    constexpr std::size_t block = 64 * 1024;
+    for (auto _ : state) {
+        SimpleBase64::Encoder encoder;
+        std::string out;
+        out.reserve((data.size() + 2) / 3 * 4); // 与 convert::encode_file 相同，按文件大小预留
+        for (std::size_t i = 0; i < data.size(); i += block) {
+            encoder.update(data.data() + i, std::min(block, data.size() - i), out);
+        }
+        encoder.finish(out);
+        benchmark::DoNotOptimize(out);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DecodeLegacy(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    const auto text = SimpleBase64::encode(data);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(LegacyBase64::decode(text));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+void BM_Decode(benchmark::State &state) {
+    const auto data = randomBytes(static_cast<std::size_t>(state.range(0)));
+    const auto text = SimpleBase64::encode(data);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(SimpleBase64::decode(text));
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+}
+
+} // namespace
+
+BENCHMARK(BM_EncodeLegacy)->Apply(sizes);
+BENCHMARK(BM_Encode)->Apply(sizes);
+BENCHMARK(BM_EncodeScalar)->Apply(sizes);
+BENCHMARK(BM_EncodeStreaming)->Apply(sizes);
+BENCHMARK(BM_DecodeLegacy)->Apply(sizes);
+BENCHMARK(BM_Decode)->Apply(sizes);
+
+BENCHMARK_MAIN();
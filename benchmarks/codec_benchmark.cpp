@@ -0,0 +1,247 @@
+#include "../src/convert.h"
+#include <QDir>
+#include <QFile>
+#include <QImage>
+#include <SimpleBase64.h>
+#include <ZXing/BarcodeFormat.h>
+#include <benchmark/benchmark.h>
+#include <cstdio>
+#include <opencv2/opencv.hpp>
+#include <random>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @file codec_benchmark.cpp
+ * @brief 生成与识别热路径的基准测试：每种条码格式 × 内容长度 × 目标尺寸
+ *
+ * 条码格式与基础内容取自 test_samples/text2QRCode/<格式>_valid.txt，容量较大的二维码格式再把内容重复到更长的长度。
+ * 每个条码格式注册以下测试（名称中依次为格式、内容字节数、目标边长）：
+ *  - Encode/QRCode/256B：encode_modules（MultiFormatWriter::encode）
+ *  - Generate/QRCode/256B/1200px：byte_to_QRCode_qimage（编码 + 光栅化）
+ *  - Rasterize/QRCode/1200px：rasterize_bitmatrix
+ *  - Resize/QRCode/1200px：resizeImageToExactSize，由 300px 的条码平滑放大
+ *  - Decode/QRCode/1200px：QRcode_to_byte，counters 中 match 为识别结果与内容是否一致
+ * 另有 Base64Encode/Base64Decode 按数据长度测试 SimpleBase64。当前 zxing 不支持生成的格式记为错误（error_occurred）。
+ *
+ * 结果用 Google Benchmark 的 JSON 输出保存，不同提交之间用 Google Benchmark 自带的 tools/compare.py 对比：
+ *
+ * @code
+ * cmake -B build -DLAB2QRCODE_BUILD_BENCHMARKS=ON && cmake --build build --target codec_benchmark
+ * ./codec_benchmark --benchmark_out=before.json --benchmark_out_format=json
+ * ./codec_benchmark --benchmark_filter='Decode/QRCode' --samples=path/to/text2QRCode
+ * compare.py benchmarks before.json after.json
+ * @endcode
+ */
+
+namespace {
+
+constexpr int targetEdges[] = {300, 1200, 4800};                         /**< 目标边长（像素）：界面默认、打印、大幅面 */
+constexpr std::size_t payloadSizes[] = {64, 256, 1024};                  /**< 可变容量格式额外测试的内容长度（字节） */
+constexpr std::size_t base64Sizes[] = {64, 1 << 10, 64 << 10, 1 << 20}; /**< Base64 测试的数据长度（字节） */
+
+/**
+ * @brief 一种条码格式的样例
+ */
+struct sample {
+    ZXing::BarcodeFormat format;
+    std::string name; /**< 格式名，用于测试名称 */
+    std::string text; /**< 样例内容 */
+};
+
+std::vector<sample> loadSamples(const QString &dir) {
+    std::vector<sample> samples;
+    for (const auto &info : QDir(dir).entryInfoList({"*_valid.txt"}, QDir::Files, QDir::Name)) {
+        const QString name = info.fileName().section('_', 0, 0);
+        const auto format = ZXing::BarcodeFormatFromString(name.toStdString());
+        if (format == ZXing::BarcodeFormat::None) {
+            spdlog::warn("无法识别样例的条码格式: {}", info.fileName().toStdString());
+            continue;
+        }
+        QFile file(info.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        std::string text = file.readAll().trimmed().toStdString();
+        if (!text.empty()) {
+            samples.push_back({format, name.toStdString(), std::move(text)});
+        }
+    }
+    return samples;
+}
+
+// 容量足够测试更长内容的格式
+bool scalable(ZXing::BarcodeFormat format) {
+    using enum ZXing::BarcodeFormat;
+    return format == QRCode || format == Aztec || format == DataMatrix || format == PDF417;
+}
+
+// 重复样例内容直到 size 字节，保持格式允许的字符集
+std::string repeatTo(const std::string &text, std::size_t size) {
+    std::string out;
+    out.reserve(size);
+    while (out.size() < size) {
+        out.append(text, 0, std::min(text.size(), size - out.size()));
+    }
+    return out;
+}
+
+convert::QRcode_create_config config(ZXing::BarcodeFormat format, int edge) {
+    return {.target_width = edge, .target_height = edge, .format = format};
+}
+
+// 1 位条码图片转换为识别使用的灰度图
+cv::Mat toGray(const QImage &image) {
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    return cv::Mat(gray.height(), gray.width(), CV_8UC1, const_cast<uchar *>(gray.constBits()), gray.bytesPerLine())
+        .clone();
+}
+
+std::string label(const sample &s, std::string_view suffix) {
+    return s.name + "/" + std::string(suffix);
+}
+
+void registerFormat(const sample &s) {
+    const auto format = s.format;
+    try {
+        (void)convert::encode_modules(s.text, config(format, targetEdges[0]));
+    } catch (const std::exception &e) {
+        // 保留在结果中，zxing 开始支持该格式后自动有数据
+        benchmark::RegisterBenchmark(("Encode/" + s.name).c_str(),
+                                     [message = std::string(e.what())](benchmark::State &state) {
+                                         state.SkipWithError(message.c_str());
+                                         for (auto _ : state) {
+                                         }
+                                     });
+        return;
+    }
+
+    std::vector<std::string> payloads{s.text};
+    if (scalable(format)) {
+        for (const auto size : payloadSizes) {
+            payloads.push_back(repeatTo(s.text, size));
+        }
+    }
+
+    for (const auto &payload : payloads) {
+        const std::string bytes = std::to_string(payload.size()) + "B";
+        benchmark::RegisterBenchmark(("Encode/" + label(s, bytes)).c_str(), [format, payload](benchmark::State &state) {
+            const auto cfg = config(format, targetEdges[0]);
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(convert::encode_modules(payload, cfg));
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(payload.size()));
+        })->Unit(benchmark::kMicrosecond);
+
+        for (const int edge : targetEdges) {
+            const std::string name = "Generate/" + label(s, bytes + "/" + std::to_string(edge) + "px");
+            benchmark::RegisterBenchmark(name.c_str(), [format, payload, edge](benchmark::State &state) {
+                const auto cfg = config(format, edge);
+                for (auto _ : state) {
+                    benchmark::DoNotOptimize(convert::byte_to_QRCode_qimage(payload, cfg));
+                }
+                state.SetItemsProcessed(state.iterations());
+            })->Unit(benchmark::kMicrosecond);
+        }
+    }
+
+    const auto modules = convert::encode_modules(s.text, config(format, targetEdges[0]));
+    const QImage small = convert::rasterize_bitmatrix(modules, targetEdges[0], targetEdges[0]);
+    for (const int edge : targetEdges) {
+        const std::string px = std::to_string(edge) + "px";
+        benchmark::RegisterBenchmark(("Rasterize/" + label(s, px)).c_str(), [modules, edge](benchmark::State &state) {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(convert::rasterize_bitmatrix(modules, edge, edge));
+            }
+            state.counters["pixels"] = static_cast<double>(edge) * edge;
+        })->Unit(benchmark::kMicrosecond);
+
+        if (edge != targetEdges[0]) {
+            benchmark::RegisterBenchmark(("Resize/" + label(s, px)).c_str(), [small, edge](benchmark::State &state) {
+                for (auto _ : state) {
+                    benchmark::DoNotOptimize(convert::resizeImageToExactSize(small, edge, edge));
+                }
+                state.counters["pixels"] = static_cast<double>(edge) * edge;
+            })->Unit(benchmark::kMicrosecond);
+        }
+
+        const cv::Mat gray = toGray(convert::rasterize_bitmatrix(modules, edge, edge));
+        benchmark::RegisterBenchmark(("Decode/" + label(s, px)).c_str(), [s, gray](benchmark::State &state) {
+            const auto probe = convert::QRcode_to_byte(gray, s.format);
+            if (!probe) {
+                state.SkipWithError("not decoded");
+            }
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(convert::QRcode_to_byte(gray, s.format));
+            }
+            state.counters["match"] = probe && probe.text == s.text ? 1 : 0;
+            state.counters["tier"] = static_cast<double>(probe.tier);
+        })->Unit(benchmark::kMicrosecond);
+    }
+}
+
+std::vector<std::uint8_t> randomBytes(std::size_t size) {
+    std::mt19937 rng(42);
+    std::vector<std::uint8_t> data(size);
+    for (auto &b : data) {
+        b = static_cast<std::uint8_t>(rng());
+    }
+    return data;
+}
+
+void registerBase64() {
+    for (const auto size : base64Sizes) {
+        const auto data = randomBytes(size);
+        const auto text = SimpleBase64::encode(data);
+        benchmark::RegisterBenchmark(("Base64Encode/" + std::to_string(size)).c_str(), [data](benchmark::State &state) {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(SimpleBase64::encode(data));
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(data.size()));
+        });
+        benchmark::RegisterBenchmark(("Base64Decode/" + std::to_string(size)).c_str(), [text](benchmark::State &state) {
+            for (auto _ : state) {
+                benchmark::DoNotOptimize(SimpleBase64::decode(text));
+            }
+            state.SetBytesProcessed(state.iterations() * static_cast<std::int64_t>(text.size()));
+        });
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    spdlog::set_level(spdlog::level::warn);
+
+    // --samples=DIR 由本程序处理，其余参数交给 Google Benchmark
+    QString samplesDir = LAB2QRCODE_SAMPLES_DIR;
+    std::vector<char *> args;
+    for (int i = 0; i < argc; ++i) {
+        constexpr std::string_view option = "--samples=";
+        if (const std::string_view arg(argv[i]); arg.starts_with(option)) {
+            samplesDir = QString::fromLocal8Bit(argv[i] + option.size());
+        } else {
+            args.push_back(argv[i]);
+        }
+    }
+
+    const auto samples = loadSamples(samplesDir);
+    if (samples.empty()) {
+        std::fprintf(stderr, "no *_valid.txt samples in %s\n", samplesDir.toLocal8Bit().constData());
+        return 2;
+    }
+    for (const auto &s : samples) {
+        registerFormat(s);
+    }
+    registerBase64();
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
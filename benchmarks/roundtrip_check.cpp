@@ -0,0 +1,394 @@
+#include "../src/convert.h"
+#include "../src/logging.h"
+#include <QBuffer>
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QImage>
+#include <QPainter>
+#include <ZXing/BarcodeFormat.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <opencv2/opencv.hpp>
+#include <spdlog/spdlog.h>
+#include <string>
+#include <variant>
+#include <vector>
+
+/**
+ * @file roundtrip_check.cpp
+ * @brief 样例语料的往返一致性与耗时检查
+ *
+ * 遍历 test_samples/text2QRCode 中每种条码格式的样例：
+ *  - <格式>_valid.txt：按界面的生成流程生成条码（encode_bytes，含光栅化），再按解码流程识别（decode_image），
+ *    检查还原出的字节与原内容一致；
+ *  - <格式>_invalid.txt：检查生成失败、没有产生图片，并且失败所用的时间不超过 --fail-budget 毫秒。
+ * 每个样例重复 --iterations 次，在 stdout 输出一行 JSON：结果、耗时分位数以及各阶段的耗时（见 convert::stage_timings）；
+ * 另有一项坐标检查：把条码放在大图中间，比较缩小识别（decode_encoded_image）与原分辨率识别得到的角点。
+ * 最后一行为按格式汇总的通过率。日志输出到 stderr。当前 zxing 不能生成的格式记为 unsupported，不计入失败。
+ * 全部通过时退出码为 0，存在失败时为 1。
+ *
+ * @code
+ * roundtrip_check
+ * roundtrip_check --margin 4 --size 1200 --iterations 50 > margin4.jsonl
+ * roundtrip_check --samples path/to/text2QRCode --base64
+ * @endcode
+ */
+
+namespace {
+
+using json = nlohmann::json;
+
+/**
+ * @brief 一个样例文件
+ */
+struct sample_file {
+    QString path;
+    ZXing::BarcodeFormat format = ZXing::BarcodeFormat::None;
+    std::string name; /**< 格式名 */
+    bool valid = true;
+    QByteArray content;
+};
+
+/**
+ * @brief 检查的参数
+ */
+struct check_settings {
+    int size = 300;          /**< 目标边长（像素） */
+    int margin = 1;          /**< 静区宽度（模块） */
+    int iterations = 20;     /**< 每个样例的重复次数 */
+    bool base64 = false;     /**< 生成前 Base64 编码，识别后解码 */
+    double fail_budget = 50; /**< 不合法内容生成失败的耗时上限（毫秒，中位数） */
+};
+
+std::vector<sample_file> loadSamples(const QString &dir) {
+    std::vector<sample_file> samples;
+    for (const auto &info : QDir(dir).entryInfoList({"*_valid.txt", "*_invalid.txt"}, QDir::Files, QDir::Name)) {
+        const QString name = info.fileName().section('_', 0, 0);
+        const auto format = ZXing::BarcodeFormatFromString(name.toStdString());
+        if (format == ZXing::BarcodeFormat::None) {
+            spdlog::warn("无法识别样例的条码格式: {}", info.fileName().toStdString());
+            continue;
+        }
+        QFile file(info.filePath());
+        if (!file.open(QIODevice::ReadOnly)) {
+            spdlog::warn("无法读取样例: {}", info.filePath().toStdString());
+            continue;
+        }
+        // 文件末尾的换行不属于内容；空文件本身就是一个不合法的样例
+        samples.push_back({info.filePath(),
+                           format,
+                           name.toStdString(),
+                           info.fileName().endsWith("_valid.txt"),
+                           file.readAll().trimmed()});
+    }
+    return samples;
+}
+
+// 1 位条码图片转换为识别使用的灰度图
+cv::Mat toGray(const QImage &image) {
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    return cv::Mat(gray.height(), gray.width(), CV_8UC1, const_cast<uchar *>(gray.constBits()), gray.bytesPerLine())
+        .clone();
+}
+
+json percentiles(std::vector<double> ms) {
+    if (ms.empty()) {
+        return nullptr;
+    }
+    std::ranges::sort(ms);
+    const auto at = [&](double p) {
+        const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(ms.size())));
+        return ms[std::clamp<std::size_t>(rank, 1, ms.size()) - 1];
+    };
+    return {
+        {"p50", at(0.50)},
+        {"p90", at(0.90)},
+        {"max", ms.back()}
+    };
+}
+
+json stageTimes(const convert::batch_timing &timing) {
+    json stages = json::object();
+    for (const auto &s : timing.stages) {
+        stages[convert::batch_stage_name(s.stage)] = {
+            {"count", s.count },
+            {"p50",   s.p50_ms},
+            {"p90",   s.p90_ms}
+        };
+    }
+    return stages;
+}
+
+convert::encode_options encodeOptions(const sample_file &sample, const check_settings &settings) {
+    return {
+        .qrcode = {.target_width = settings.size,
+                   .target_height = settings.size,
+                   .format = sample.format,
+                   .margin = settings.margin},
+        .use_base64 = settings.base64,
+    };
+}
+
+/**
+ * @brief 合法样例：生成 → 光栅化 → 识别，还原出的字节与原内容一致时通过
+ */
+json checkValid(const sample_file &sample, const check_settings &settings) {
+    const auto options = encodeOptions(sample, settings);
+    const convert::decode_options decode{.use_base64 = settings.base64, .formats = sample.format, .tile_size = 0};
+
+    std::string status = "pass";
+    std::string error;
+    std::vector<double> encodeMs;
+    std::vector<double> decodeMs;
+    convert::stage_timings::instance().begin();
+    for (int i = 0; i < settings.iterations && status == "pass"; ++i) {
+        QElapsedTimer clock;
+        clock.start();
+        convert::barcode_symbol symbol;
+        try {
+            symbol = convert::encode_bytes(sample.content, options);
+        } catch (const std::exception &e) {
+            error = e.what();
+            status = error.find("nsupported") != std::string::npos ? "unsupported" : "fail";
+            break;
+        }
+        encodeMs.push_back(clock.nsecsElapsed() / 1e6);
+        if (symbol.image.isNull()) {
+            status = "fail";
+            error = "no image";
+            break;
+        }
+
+        const cv::Mat gray = toGray(symbol.image);
+        clock.start();
+        const auto entry = convert::decode_image(sample.path, gray, decode);
+        decodeMs.push_back(clock.nsecsElapsed() / 1e6);
+        if (const auto *err = std::get_if<std::string>(&entry.data)) {
+            status = "fail";
+            error = *err;
+        } else if (const auto *bytes = std::get_if<QByteArray>(&entry.data); bytes == nullptr) {
+            status = "fail";
+            error = "no content";
+        } else if (*bytes != sample.content) {
+            status = "fail";
+            error = "mismatch: " + bytes->toStdString();
+        }
+    }
+    const auto timing = convert::stage_timings::instance().finish(static_cast<int>(encodeMs.size()));
+
+    json line{
+        {"format",    sample.name          },
+        {"sample",    "valid"              },
+        {"bytes",     sample.content.size()},
+        {"status",    status               },
+        {"encode_ms", percentiles(encodeMs)},
+        {"decode_ms", percentiles(decodeMs)},
+        {"stages",    stageTimes(timing)   }
+    };
+    if (!error.empty()) {
+        line["error"] = error;
+    }
+    return line;
+}
+
+/**
+ * @brief 不合法样例：生成失败、没有产生图片，且失败的耗时不超过上限时通过
+ */
+json checkInvalid(const sample_file &sample, const check_settings &settings) {
+    const auto options = encodeOptions(sample, settings);
+
+    std::string status = "pass";
+    std::string error;
+    bool threw = false;
+    std::vector<double> failMs;
+    for (int i = 0; i < settings.iterations; ++i) {
+        QElapsedTimer clock;
+        clock.start();
+        convert::barcode_symbol symbol;
+        try {
+            symbol = convert::encode_bytes(sample.content, options);
+        } catch (const std::exception &e) {
+            threw = true;
+            error = e.what();
+        }
+        failMs.push_back(clock.nsecsElapsed() / 1e6);
+        if (symbol) {
+            // 生成成功或留下了部分结果
+            status = "fail";
+            error = symbol.image.isNull() ? "partial symbol" : "encoded";
+            break;
+        }
+    }
+
+    json line{
+        {"format",    sample.name          },
+        {"sample",    "invalid"            },
+        {"bytes",     sample.content.size()},
+        {"exception", threw                },
+        {"fail_ms",   percentiles(failMs)  }
+    };
+    if (status == "pass" && line["fail_ms"]["p50"].get<double>() > settings.fail_budget) {
+        status = "slow";
+    }
+    line["status"] = status;
+    if (!error.empty()) {
+        line["error"] = error;
+    }
+    return line;
+}
+
+/**
+ * @brief 坐标检查：大图先缩小识别时，结果的角点须换算回原图，与原分辨率识别的角点相差不超过缩小倍数
+ */
+json checkPosition() {
+    constexpr int canvasEdge = 4096;
+    constexpr int symbolEdge = 1200;
+    const QPoint offset(1500, 2100);
+    const auto symbol = convert::encode_bytes("Lab2QRCode position check",
+                                              {.qrcode = {.target_width = symbolEdge,
+                                                          .target_height = symbolEdge,
+                                                          .format = ZXing::BarcodeFormat::QRCode},
+                                               .use_base64 = false});
+
+    // 条码不在原点，坐标没有换算时偏差明显
+    QImage canvas(canvasEdge, canvasEdge, QImage::Format_RGB32);
+    canvas.fill(Qt::white);
+    QPainter(&canvas).drawImage(offset, symbol.image);
+    QByteArray png;
+    QBuffer buffer(&png);
+    buffer.open(QIODevice::WriteOnly);
+    canvas.save(&buffer, "PNG");
+
+    // 缩小识别找到条码即返回，结果只来自缩小识别
+    const convert::decode_options options{.use_base64 = false, .formats = ZXing::BarcodeFormat::QRCode, .tile_size = 0};
+    const auto *data = reinterpret_cast<const uchar *>(png.constData());
+    const auto size = static_cast<std::size_t>(png.size());
+    const int factor = convert::reduction_factor(convert::encoded_image_size(data, size), options.reduce_min_edge);
+    const auto reduced = convert::decode_encoded_image("position", data, size, options);
+    const auto full = convert::decode_image("position", convert::decode_grayscale(data, size), options);
+
+    std::string status = "pass";
+    int maxError = 0;
+    if (!reduced || !full || factor < 2) {
+        status = "fail";
+    } else {
+        for (std::size_t i = 0; i < reduced.position.size(); ++i) {
+            maxError = std::max({maxError,
+                                 std::abs(reduced.position[i].x - full.position[i].x),
+                                 std::abs(reduced.position[i].y - full.position[i].y)});
+        }
+        if (maxError > factor) {
+            status = "fail";
+        }
+    }
+    return {
+        {"check",     "position"},
+        {"factor",    factor    },
+        {"max_error", maxError  },
+        {"status",    status    }
+    };
+}
+
+void printLine(const json &line) {
+    std::cout << line.dump(-1, ' ', false, json::error_handler_t::replace) << '\n' << std::flush;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("roundtrip_check");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(
+        "Round-trips every *_valid.txt sample through encode, rasterize and decode, and checks that every "
+        "*_invalid.txt sample fails to encode quickly. Prints one JSON line per sample and a summary line.");
+    parser.addHelpOption();
+    const QCommandLineOption samplesOption(
+        "samples", "Sample directory (default: test_samples/text2QRCode).", "dir", LAB2QRCODE_SAMPLES_DIR);
+    const QCommandLineOption sizeOption("size", "Target width and height in pixels.", "px", "300");
+    const QCommandLineOption marginOption("margin", "Quiet zone margin.", "margin", "1");
+    const QCommandLineOption iterationsOption("iterations", "Repetitions per sample.", "n", "20");
+    const QCommandLineOption base64Option("base64", "Base64-encode the content before encoding.");
+    const QCommandLineOption budgetOption(
+        "fail-budget", "Maximum median time for an invalid sample to fail, in ms.", "ms", "50");
+    const QCommandLineOption verboseOption({"v", "verbose"}, "Log progress to stderr.");
+    parser.addOptions(
+        {samplesOption, sizeOption, marginOption, iterationsOption, base64Option, budgetOption, verboseOption});
+    parser.process(app);
+
+    Logging::setupCliLogging(parser.isSet(verboseOption) ? spdlog::level::info : spdlog::level::warn);
+
+    const check_settings settings{
+        .size = std::max(parser.value(sizeOption).toInt(), 1),
+        .margin = std::max(parser.value(marginOption).toInt(), 0),
+        .iterations = std::max(parser.value(iterationsOption).toInt(), 1),
+        .base64 = parser.isSet(base64Option),
+        .fail_budget = parser.value(budgetOption).toDouble(),
+    };
+
+    const auto samples = loadSamples(parser.value(samplesOption));
+    if (samples.empty()) {
+        spdlog::error("没有样例: {}", parser.value(samplesOption).toStdString());
+        return 2;
+    }
+
+    struct tally {
+        int passed = 0;
+        int total = 0;
+    };
+    std::map<std::string, tally> formats;
+    int failed = 0;
+    int unsupported = 0;
+    for (const auto &sample : samples) {
+        const json line = sample.valid ? checkValid(sample, settings) : checkInvalid(sample, settings);
+        printLine(line);
+
+        const auto status = line["status"].get<std::string>();
+        spdlog::info("{} {}: {}", sample.name, sample.valid ? "valid" : "invalid", status);
+        if (status == "unsupported") {
+            ++unsupported;
+            continue;
+        }
+        auto &t = formats[sample.name];
+        ++t.total;
+        if (status == "pass") {
+            ++t.passed;
+        } else {
+            ++failed;
+        }
+    }
+
+    const json position = checkPosition();
+    printLine(position);
+    if (position["status"] != "pass") {
+        ++failed;
+    }
+
+    json summary{
+        {"summary",     true           },
+        {"size",        settings.size  },
+        {"margin",      settings.margin},
+        {"base64",      settings.base64},
+        {"failed",      failed         },
+        {"unsupported", unsupported    }
+    };
+    auto &rates = summary["pass_rate"] = json::object();
+    for (const auto &[name, t] : formats) {
+        rates[name] = static_cast<double>(t.passed) / t.total;
+    }
+    printLine(summary);
+
+    if (failed > 0) {
+        spdlog::warn("{} 个样例未通过", failed);
+    }
+    return failed == 0 ? 0 : 1;
+}
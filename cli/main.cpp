@@ -0,0 +1,640 @@
+#include "../src/codec/hot_folder.h"
+#include "../src/convert.h"
+#include "../src/logging.h"
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QRegularExpression>
+#include <QThreadPool>
+#include <QtConcurrent>
+#include <ZXing/BarcodeFormat.h>
+#include <algorithm>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <set>
+#include <opencv2/opencv.hpp>
+#include <spdlog/spdlog.h>
+
+#ifdef _WIN32
+    #include <fcntl.h>
+    #include <io.h>
+#endif
+
+/**
+ * @file main.cpp
+ * @brief lab2qrcode-cli：无界面的批量生成/解码工具
+ *
+ * 不依赖 QtWidgets，可在无显示环境的服务器、cron 与构建流水线中运行。
+ * 每个输入文件对应 stdout 上的一行 JSON（JSONL），日志输出到 stderr。
+ *
+ * @code
+ * lab2qrcode-cli encode -f QRCode -o out/ data/*.rfa
+ * lab2qrcode-cli decode -o out/ "scans/*.png"
+ * cat a.rfa | lab2qrcode-cli encode -o out/ -
+ * lab2qrcode-cli encode --chunk-size 1024 -o out/ big.rfa
+ * lab2qrcode-cli decode -o restored/ "out/big_*.png"
+ * lab2qrcode-cli encode --output-format svg -o out/ data/*.rfa
+ * lab2qrcode-cli decode --watch inbox/
+ * lab2qrcode-cli encode --timing -o out/ data/*.rfa
+ * @endcode
+ */
+
+namespace {
+
+using json = nlohmann::json;
+
+constexpr auto stdin_name = "-";
+
+/**
+ * @brief 单个待处理的输入
+ */
+struct cli_input {
+    QString path;       /**< 文件路径，stdin 时为 "-" */
+    QByteArray content; /**< 从 stdin 读取的全部内容 */
+    int page = -1;      /**< 解码多页 TIFF 时的页序号（从0开始），-1 表示整个文件 */
+};
+
+/**
+ * @brief 单个输入的处理结果，对应输出中的一行
+ */
+struct cli_result {
+    json line;
+    bool ok = false;
+    std::vector<convert::result_data_entry> fragments; /**< 解码得到的分块，所有输入处理完后统一重组 */
+    std::vector<convert::decode_tier> tiers;           /**< 各条码识别成功的层级 */
+};
+
+/**
+ * @brief 展开输入参数：普通文件原样保留，包含通配符的参数按 QDir 通配规则展开
+ */
+QStringList expandInputs(const QStringList &args) {
+    static const QRegularExpression wildcard(R"([*?\[])");
+
+    QStringList files;
+    for (const auto &arg : args) {
+        if (arg == stdin_name || !arg.contains(wildcard)) {
+            files.append(arg);
+            continue;
+        }
+
+        const QFileInfo info(arg);
+        const QDir dir = info.dir();
+        const auto matches = dir.entryInfoList({info.fileName()}, QDir::Files, QDir::Name);
+        if (matches.isEmpty()) {
+            spdlog::warn("通配符未匹配到任何文件: {}", arg.toStdString());
+        }
+        for (const auto &match : matches) {
+            files.append(match.filePath());
+        }
+    }
+    return files;
+}
+
+QByteArray readStdin() {
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+    QFile in;
+    if (!in.open(stdin, QIODevice::ReadOnly)) {
+        return {};
+    }
+    return in.readAll();
+}
+
+/**
+ * @brief 计算输出文件路径：指定了输出目录时写入该目录，否则写在输入文件旁边
+ */
+QString outputPath(const QString &outputDir, const QString &input, const QString &targetName) {
+    if (!outputDir.isEmpty()) {
+        return QDir(outputDir).filePath(targetName);
+    }
+    if (input == stdin_name) {
+        return QDir::current().filePath(targetName);
+    }
+    return QFileInfo(input).dir().filePath(targetName);
+}
+
+/**
+ * @brief 结果的输出设置，解析命令行后确定，随工作函数传入各线程
+ */
+struct output_options {
+    QString dir;                  /**< 输出目录，为空时写在输入文件旁边 */
+    QString image_suffix = "png"; /**< 条码的保存格式（png、svg 或 pdf），由 --output-format 设置 */
+    int png_level = 6;            /**< 保存 PNG 时的 zlib 压缩级别，由 --png-level 设置 */
+    bool write_timing = false;    /**< 是否把各阶段的耗时汇总写入输出目录（lab2qrcode_timing.json），由 --timing 设置 */
+};
+
+/**
+ * @brief 将单个图片或文件结果写入 dest，并把尺寸/长度填入 line
+ * @return 是否写入成功
+ */
+bool writeEntry(const convert::result_data_entry &entry, const QString &dest, int pngLevel, json &line) {
+    if (const auto *img = std::get_if<QImage>(&entry.data)) {
+        // 只输出矢量格式时不生成位图，尺寸取自模块矩阵对应的目标尺寸
+        line["width"] = entry.vector ? entry.vector->width : img->width();
+        line["height"] = entry.vector ? entry.vector->height : img->height();
+    } else if (const auto *data = std::get_if<QByteArray>(&entry.data)) {
+        line["bytes"] = data->size();
+    }
+    return convert::save_entry(entry, dest, pngLevel);
+}
+
+/**
+ * @brief 将结果写入磁盘，并把结果信息填入 JSON 行
+ *
+ * 分块生成的结果写出全部分块图片，输出路径列在 "outputs" 中；
+ * 一张图中识别到多个条码时，每个条码各写出一个文件，各条码的信息列在 "symbols" 中；
+ * 解码得到的分块不写盘，留待 reassemble_chunks 重组。
+ */
+cli_result writeResult(convert::result_data_entry entry, const QString &input, const output_options &output) {
+    cli_result res;
+    res.line["input"] = input.toStdString();
+
+    if (entry.barcode_format != ZXing::BarcodeFormat::None) {
+        res.line["format"] = ZXing::ToString(entry.barcode_format);
+        auto &position = res.line["position"] = json::array();
+        for (const auto &p : entry.position) {
+            position.push_back({p.x, p.y});
+        }
+    }
+    if (entry.tier != convert::decode_tier::none) {
+        res.line["tier"] = convert::decode_tier_name(entry.tier);
+        res.tiers.push_back(entry.tier);
+    }
+
+    if (const auto *err = std::get_if<std::string>(&entry.data)) {
+        res.line["ok"] = false;
+        res.line["error"] = *err;
+        return res;
+    }
+
+    if (const auto *fragment = std::get_if<convert::chunk_fragment>(&entry.data)) {
+        res.ok = true;
+        res.line["ok"] = true;
+        res.line["chunk"] = {
+            {"file_id", fmt::format("{:08x}", fragment->file_id)},
+            {"index",   fragment->index                          },
+            {"count",   fragment->count                          }
+        };
+        res.fragments.push_back(std::move(entry));
+        return res;
+    }
+
+    if (!entry.parts.empty() && entry.parts.front().symbol_count > 0) {
+        res.ok = true;
+        auto &symbols = res.line["symbols"] = json::array();
+        for (auto &part : entry.parts) {
+            const int index = part.symbol_index;
+            auto sub = writeResult(std::move(part), input, output);
+            sub.line.erase("input");
+            sub.line["index"] = index;
+            res.ok = res.ok && sub.ok;
+            std::ranges::move(sub.fragments, std::back_inserter(res.fragments));
+            res.tiers.insert(res.tiers.end(), sub.tiers.begin(), sub.tiers.end());
+            symbols.push_back(std::move(sub.line));
+        }
+        res.line["ok"] = res.ok;
+        return res;
+    }
+
+    if (!entry.parts.empty()) {
+        res.ok = true;
+        auto &outputs = res.line["outputs"] = json::array();
+        for (const auto &part : entry.parts) {
+            if (const auto *err = std::get_if<std::string>(&part.data)) {
+                res.ok = false;
+                res.line["error"] = fmt::format("chunk {}/{}: {}", part.chunk_index, part.chunk_count, *err);
+                continue;
+            }
+            const QString dest = outputPath(output.dir, input, part.get_default_target_name(output.image_suffix));
+            if (writeEntry(part, dest, output.png_level, res.line)) {
+                outputs.push_back(dest.toStdString());
+            } else {
+                res.ok = false;
+                res.line["error"] = "failed to write output";
+            }
+        }
+        res.line["ok"] = res.ok;
+        res.line["chunks"] = entry.parts.size();
+        return res;
+    }
+
+    const QString dest = outputPath(output.dir, input, entry.get_default_target_name(output.image_suffix));
+    const bool written = writeEntry(entry, dest, output.png_level, res.line);
+
+    res.ok = written;
+    res.line["ok"] = written;
+    res.line["output"] = dest.toStdString();
+    if (!written) {
+        res.line["error"] = "failed to write output";
+    }
+    return res;
+}
+
+/**
+ * @brief encode 子命令的工作函数
+ */
+struct encode_worker {
+    using result_type = cli_result;
+
+    convert::encode_options options;
+    output_options output;
+
+    cli_result operator()(const cli_input &input) const {
+        auto entry = input.path == stdin_name ? convert::encode_data("stdin", input.content, options)
+                                              : convert::encode_file(input.path, options);
+        return writeResult(std::move(entry), input.path, output);
+    }
+};
+
+/**
+ * @brief decode 子命令的工作函数
+ */
+struct decode_worker {
+    using result_type = cli_result;
+
+    convert::decode_options options;
+    output_options output;
+
+    cli_result operator()(const cli_input &input) const {
+        if (input.path == stdin_name) {
+            auto entry = convert::decode_encoded_image("stdin",
+                                                       reinterpret_cast<const uchar *>(input.content.constData()),
+                                                       static_cast<std::size_t>(input.content.size()),
+                                                       options);
+            return writeResult(std::move(entry), input.path, output);
+        }
+        const convert::decode_task task{input.path, input.page};
+        return writeResult(convert::decode_task_file(task, options), task.source_name(), output);
+    }
+};
+
+/**
+ * @brief 解码前展开输入：多页 TIFF 展开为每页一个输入，各页并行解码，结果按 file.tif#p3 逐页输出
+ */
+QList<cli_input> expandPages(const QList<cli_input> &inputs) {
+    QList<cli_input> pages;
+    for (const auto &input : inputs) {
+        if (input.path == stdin_name) {
+            pages.append(input);
+            continue;
+        }
+        for (const auto &task : convert::expand_decode_tasks({input.path})) {
+            pages.append({task.path, {}, task.page});
+        }
+    }
+    return pages;
+}
+
+void printLine(const json &line) {
+    std::cout << line.dump(-1, ' ', false, json::error_handler_t::replace) << '\n' << std::flush;
+}
+
+/**
+ * @brief 并行处理所有输入，按输入顺序逐行输出 JSONL
+ * @param useBase64 重组分块后是否进行 Base64 解码（仅 decode 会产生分块）
+ * @param output 重组后文件的输出设置，与工作函数的相同
+ * @return 全部成功返回 0，否则返回 1
+ *
+ * 解码得到的分块先各自输出一行，全部输入处理完后再按文件重组，每个重组结果额外输出一行。
+ */
+template <typename Worker>
+int run(const QList<cli_input> &inputs, Worker worker, bool useBase64, const output_options &output) {
+    convert::stage_timings::instance().begin();
+    auto future = QtConcurrent::mapped(inputs, std::move(worker));
+
+    int failed = 0;
+    std::map<convert::decode_tier, int> tiers;
+    std::vector<convert::result_data_entry> fragments;
+    for (int i = 0; i < inputs.size(); ++i) {
+        // resultAt 会阻塞到第 i 个结果就绪，因此结果按输入顺序尽早输出
+        const cli_result &res = future.resultAt(i);
+        if (!res.ok) {
+            ++failed;
+        }
+        fragments.insert(fragments.end(), res.fragments.begin(), res.fragments.end());
+        for (const auto tier : res.tiers) {
+            ++tiers[tier];
+        }
+        printLine(res.line);
+    }
+
+    convert::reassemble_chunks(fragments, useBase64);
+    for (auto &entry : fragments) {
+        const QString source = entry.source_file_name;
+        auto res = writeResult(std::move(entry), source, output);
+        res.line["assembled"] = true;
+        if (!res.ok) {
+            ++failed;
+        }
+        printLine(res.line);
+    }
+
+    spdlog::info("处理完成: 总计 {}, 失败 {}", inputs.size(), failed);
+    if (!tiers.empty()) {
+        spdlog::info("解码层级: pure {}, hinted {}, full {}",
+                     tiers[convert::decode_tier::pure],
+                     tiers[convert::decode_tier::hinted],
+                     tiers[convert::decode_tier::full]);
+    }
+
+    const auto timing = convert::stage_timings::instance().finish(inputs.size());
+    timing.log("批处理");
+    if (output.write_timing) {
+        const QDir dir(output.dir.isEmpty() ? QDir::currentPath() : output.dir);
+        const QString path = dir.filePath(convert::timing_file_name);
+        if (!convert::write_file(path, timing.to_json())) {
+            spdlog::error("无法写入耗时汇总: {}", path.toStdString());
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}
+
+/**
+ * @brief 取出已收齐全部分块的文件并重组，未收齐的分块留在 fragments 中等待之后的文件
+ */
+std::vector<convert::result_data_entry> takeCompleteChunks(std::vector<convert::result_data_entry> &fragments,
+                                                           bool useBase64) {
+    // 与 reassemble_chunks 相同，按文件ID与总数分组
+    std::map<std::pair<std::uint32_t, int>, std::set<int>> received;
+    for (const auto &entry : fragments) {
+        const auto &fragment = std::get<convert::chunk_fragment>(entry.data);
+        received[{fragment.file_id, fragment.count}].insert(fragment.index);
+    }
+
+    std::vector<convert::result_data_entry> complete;
+    std::vector<convert::result_data_entry> waiting;
+    for (auto &entry : fragments) {
+        const auto &fragment = std::get<convert::chunk_fragment>(entry.data);
+        const auto &indices = received[{fragment.file_id, fragment.count}];
+        auto &target = static_cast<int>(indices.size()) >= fragment.count ? complete : waiting;
+        target.push_back(std::move(entry));
+    }
+    fragments = std::move(waiting);
+    convert::reassemble_chunks(complete, useBase64);
+    return complete;
+}
+
+/**
+ * @brief 监视目录，文件写完后立即在线程池中处理，每个结果逐行输出 JSONL，一直运行到进程被终止
+ * @param filters 处理的文件名通配符，为空表示全部文件
+ * @param work 处理一个文件，多页 TIFF 每页一个结果
+ * @return 无法监视目录时返回 2
+ *
+ * 分块在收齐同一文件的全部分块后立即重组输出，不必等到所有输入处理完。
+ */
+int watch(const QString &dir,
+          const QStringList &filters,
+          int settleMs,
+          std::function<QList<cli_result>(const QString &)> work,
+          bool useBase64,
+          const output_options &output) {
+    std::vector<convert::result_data_entry> fragments;
+    convert::hot_folder<QList<cli_result>> folder(
+        {.dir = dir, .name_filters = filters, .settle_ms = settleMs},
+        std::move(work),
+        [&](const QString &, const QList<cli_result> &results) {
+            for (const auto &res : results) {
+                fragments.insert(fragments.end(), res.fragments.begin(), res.fragments.end());
+                printLine(res.line);
+            }
+            for (auto &entry : takeCompleteChunks(fragments, useBase64)) {
+                const QString source = entry.source_file_name;
+                auto res = writeResult(std::move(entry), source, output);
+                res.line["assembled"] = true;
+                printLine(res.line);
+            }
+        });
+    if (!folder.start()) {
+        return 2;
+    }
+    spdlog::info("输出目录: {}", output.dir.toStdString());
+    return QCoreApplication::exec();
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("lab2qrcode-cli");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Lab2QRCode headless batch encoder/decoder. Prints one JSON line per input.");
+    parser.addHelpOption();
+    parser.addPositionalArgument("command", "encode | decode");
+    parser.addPositionalArgument("inputs", "Files, wildcard patterns (quote them) or - for stdin.", "[inputs...]");
+
+    const QCommandLineOption formatOption(
+        {"f", "format"}, "Barcode format used by encode, and tried first by decode.", "format", "QRCode");
+    const QCommandLineOption widthOption({"W", "width"}, "Target image width in pixels.", "px", "300");
+    const QCommandLineOption heightOption({"H", "height"}, "Target image height in pixels.", "px", "300");
+    const QCommandLineOption marginOption("margin", "Quiet zone margin.", "margin", "1");
+    const QCommandLineOption ppiOption("ppi", "PPI written into the image metadata.", "ppi", "300");
+    const QCommandLineOption noBase64Option("no-base64", "Disable the Base64 step.");
+    const QCommandLineOption binaryOption("binary", "Write the raw bytes in byte mode (no Base64, smaller symbols).");
+    const QCommandLineOption compressOption(
+        {"z", "compress"}, "Deflate the payload first when that makes it smaller (Base64 and binary modes).");
+    const QCommandLineOption compressLevelOption("compress-level", "zlib compression level (1-9).", "level", "6");
+    const QCommandLineOption chunkSizeOption(
+        "chunk-size", "Split payloads longer than n bytes across several symbols (0: off).", "n", "0");
+    const QCommandLineOption pngLevelOption("png-level", "zlib level of the written PNG files (0-9).", "level", "6");
+    const QCommandLineOption reduceEdgeOption(
+        "reduce-edge",
+        "decode: try large scans at a reduced resolution first, keeping the long edge >= px (0: off).",
+        "px",
+        "1024");
+    const QCommandLineOption tileSizeOption(
+        "tile-size",
+        "decode: split images larger than 1.5x px into overlapping tiles decoded in parallel (0: off).",
+        "px",
+        "2048");
+    const QCommandLineOption multiSymbolOption(
+        "multi-symbol",
+        "decode: images hold several labels; skip the reduced pass so small barcodes are not missed.");
+    const QCommandLineOption outputFormatOption(
+        "output-format", "Format of the written barcodes: png, svg or pdf (vector).", "format", "png");
+    const QCommandLineOption cacheMbOption(
+        "cache-mb", "Keep generated barcode images in memory up to mb and reuse repeated content.", "mb", "256");
+    const QCommandLineOption cacheDirOption(
+        "cache-dir",
+        "Write images evicted from the --cache-mb memory cache to dir and reuse them, also in later runs.",
+        "dir");
+    const QCommandLineOption decodeCacheOption(
+        "decode-cache", "decode: reuse results of images already decoded with the same options.", "dir");
+    const QCommandLineOption decodeCacheMbOption(
+        "decode-cache-mb", "decode: disk budget of --decode-cache; least recently used results go first.", "mb", "256");
+    const QCommandLineOption watchOption(
+        "watch",
+        "Watch dir and process every file as soon as it is completely written, until killed. "
+        "Outputs go to --output, or to dir_output next to dir.",
+        "dir");
+    const QCommandLineOption settleOption(
+        "settle", "watch: a file is complete once its size and mtime are unchanged for ms.", "ms", "1000");
+    const QCommandLineOption timingOption(
+        "timing", "Write per-stage timings and throughput to lab2qrcode_timing.json in the output directory.");
+    const QCommandLineOption outputOption(
+        {"o", "output"}, "Output directory (default: next to each input).", "dir");
+    const QCommandLineOption jobsOption({"j", "jobs"}, "Number of worker threads (default: all cores).", "n");
+    const QCommandLineOption verboseOption({"v", "verbose"}, "Log progress to stderr.");
+    parser.addOptions({formatOption,
+                       widthOption,
+                       heightOption,
+                       marginOption,
+                       ppiOption,
+                       noBase64Option,
+                       binaryOption,
+                       compressOption,
+                       compressLevelOption,
+                       chunkSizeOption,
+                       pngLevelOption,
+                       outputFormatOption,
+                       reduceEdgeOption,
+                       tileSizeOption,
+                       multiSymbolOption,
+                       cacheMbOption,
+                       cacheDirOption,
+                       decodeCacheOption,
+                       decodeCacheMbOption,
+                       watchOption,
+                       settleOption,
+                       timingOption,
+                       outputOption,
+                       jobsOption,
+                       verboseOption});
+    parser.process(app);
+
+    Logging::setupCliLogging(parser.isSet(verboseOption) ? spdlog::level::debug : spdlog::level::warn);
+
+    const QStringList positional = parser.positionalArguments();
+    const bool watching = parser.isSet(watchOption);
+    if (positional.size() < (watching ? 1 : 2)) {
+        parser.showHelp(2);
+    }
+
+    const QString command = positional.front();
+    if (command != "encode" && command != "decode") {
+        spdlog::error("未知子命令: {}", command.toStdString());
+        parser.showHelp(2);
+    }
+
+    if (parser.isSet(jobsOption)) {
+        if (const int jobs = parser.value(jobsOption).toInt(); jobs > 0) {
+            QThreadPool::globalInstance()->setMaxThreadCount(jobs);
+        }
+    }
+
+    const QString watchDir = parser.value(watchOption);
+    const int settleMs = std::max(parser.value(settleOption).toInt(), 0);
+    QString outputDir = parser.value(outputOption);
+    if (watching && outputDir.isEmpty()) {
+        // 输出写到监视目录旁边，写出的文件不会再被监视目录接收
+        const QFileInfo info(QDir(watchDir).absolutePath());
+        outputDir = info.dir().filePath(info.fileName() + "_output");
+    }
+    if (watching && QDir(outputDir).absolutePath() == QDir(watchDir).absolutePath()) {
+        spdlog::error("输出目录不能是监视的目录: {}", outputDir.toStdString());
+        return 2;
+    }
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) {
+        spdlog::error("无法创建输出目录: {}", outputDir.toStdString());
+        return 2;
+    }
+
+    QList<cli_input> inputs;
+    if (watching) {
+        if (positional.size() > 1) {
+            spdlog::warn("监视模式下忽略命令行中的输入");
+        }
+    } else {
+        for (const auto &path : expandInputs(positional.mid(1))) {
+            inputs.append({path, path == stdin_name ? readStdin() : QByteArray{}});
+        }
+        if (inputs.isEmpty()) {
+            spdlog::error("没有可处理的输入");
+            return 2;
+        }
+    }
+
+    const bool useBase64 = !parser.isSet(noBase64Option);
+    output_options output{
+        .dir = outputDir,
+        .png_level = std::clamp(parser.value(pngLevelOption).toInt(), 0, 9),
+        .write_timing = parser.isSet(timingOption),
+    };
+
+    const auto format = ZXing::BarcodeFormatFromString(parser.value(formatOption).toStdString());
+    if (format == ZXing::BarcodeFormat::None) {
+        spdlog::error("不支持的条码格式: {}", parser.value(formatOption).toStdString());
+        return 2;
+    }
+
+    if (command == "decode") {
+        const convert::decode_options options{
+            .use_base64 = useBase64,
+            .reduce_min_edge = std::max(parser.value(reduceEdgeOption).toInt(), 0),
+            .formats = format,
+            .tile_size = std::max(parser.value(tileSizeOption).toInt(), 0),
+            .multi_symbol = parser.isSet(multiSymbolOption),
+        };
+        if (parser.isSet(decodeCacheOption)) {
+            const auto budgetMb = static_cast<std::size_t>(std::max(parser.value(decodeCacheMbOption).toInt(), 1));
+            convert::decode_cache::instance().configure(
+                {.dir = parser.value(decodeCacheOption), .byte_budget = budgetMb << 20});
+        }
+        const decode_worker worker{options, output};
+        if (watching) {
+            // 与 GUI 相同的图片类型；多页 TIFF 的各页在线程池中并行解码
+            const QStringList filters{"*.png", "*.jpg", "*.jpeg", "*.bmp", "*.gif", "*.tif", "*.tiff", "*.webp"};
+            const auto work = [worker](const QString &path) {
+                return QtConcurrent::blockingMapped<QList<cli_result>>(expandPages({cli_input{path}}), worker);
+            };
+            return watch(watchDir, filters, settleMs, work, useBase64, output);
+        }
+        const int code = run(expandPages(inputs), worker, useBase64, output);
+        convert::decode_cache::instance().log_stats();
+        return code;
+    }
+
+    // 与界面相同：图片先保留在内存中，超出预算被淘汰时才写入缓存目录
+    const bool useImageCache = parser.isSet(cacheMbOption) || parser.isSet(cacheDirOption);
+    if (useImageCache) {
+        const auto budgetMb = static_cast<std::size_t>(std::max(parser.value(cacheMbOption).toInt(), 0));
+        convert::image_cache::instance().configure(
+            {.memory_budget = budgetMb << 20, .spill_dir = parser.value(cacheDirOption)});
+    }
+
+    output.image_suffix = parser.value(outputFormatOption).toLower();
+    if (output.image_suffix != "png" && output.image_suffix != "svg" && output.image_suffix != "pdf") {
+        spdlog::error("不支持的输出格式: {}", output.image_suffix.toStdString());
+        return 2;
+    }
+
+    const convert::encode_options options{
+        .qrcode = {.target_width = parser.value(widthOption).toInt(),
+                   .target_height = parser.value(heightOption).toInt(),
+                   .format = format,
+                   .margin = parser.value(marginOption).toInt()},
+        .ppi = parser.value(ppiOption).toInt(),
+        .use_base64 = useBase64,
+        .binary = parser.isSet(binaryOption),
+        .compress = parser.isSet(compressOption),
+        .compression_level = std::clamp(parser.value(compressLevelOption).toInt(), 1, 9),
+        .chunk_size = parser.value(chunkSizeOption).toULongLong(),
+        .rasterize = output.image_suffix == "png",
+    };
+    const encode_worker worker{options, output};
+    if (watching) {
+        const auto work = [worker](const QString &path) { return QList<cli_result>{worker(cli_input{path})}; };
+        return watch(watchDir, {}, settleMs, work, useBase64, output);
+    }
+    const int code = run(inputs, worker, useBase64, output);
+    if (useImageCache) {
+        convert::image_cache::instance().log_stats();
+    }
+    return code;
+}
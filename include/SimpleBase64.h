@@ -1,60 +1,412 @@
 #pragma once
+#include <array>
 #include <cstdint>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#if !defined(SIMPLEBASE64_NO_SIMD) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64))
+    #define SIMPLEBASE64_X86 1
+    #include <immintrin.h>
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #define SIMPLEBASE64_TARGET(isa)
+    #else
+        #define SIMPLEBASE64_TARGET(isa) __attribute__((target(isa)))
+    #endif
+#endif
+
+/**
+ * @brief 查表 + SIMD 的 Base64 编解码
+ *
+ * 编码表与解码表在编译期生成；x86 上运行时检测 CPU，依次选择 AVX2 / SSSE3 / 标量实现，
+ * 定义 SIMPLEBASE64_NO_SIMD 可强制只使用标量实现。
+ * 解码语义与旧实现一致：跳过非 Base64 字符，遇到 '=' 停止。
+ * Encoder / Decoder 提供分段（流式）接口，大文件可以边读边编码，无需同时持有原始数据与编码结果。
+ */
 namespace SimpleBase64 {
 
-    static const char* base64_chars = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
-                                      "abcdefghijklmnopqrstuvwxyz"
-                                      "0123456789+/";
+    namespace detail {
+
+        inline constexpr char encode_table[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ"
+                                               "abcdefghijklmnopqrstuvwxyz"
+                                               "0123456789+/";
+
+        inline constexpr std::int8_t invalid = -1;
+        inline constexpr std::int8_t padding = -2;
+
+        inline constexpr auto decode_table = [] {
+            std::array<std::int8_t, 256> table{};
+            for (auto &v : table) {
+                v = invalid;
+            }
+            for (int i = 0; i < 64; ++i) {
+                table[static_cast<unsigned char>(encode_table[i])] = static_cast<std::int8_t>(i);
+            }
+            table['='] = padding;
+            return table;
+        }();
+
+        /**
+         * @brief 解码状态，跨分段保存未凑满一个字节的比特
+         */
+        struct decode_state {
+            std::uint32_t val = 0;
+            int valb = -8;
+            bool done = false; /**< 已遇到 '='，后续输入全部忽略 */
+        };
+
+        // 标量编码：编码 len / 3 个完整的三字节组，返回消耗的字节数
+        inline std::size_t encode_blocks_scalar(const std::uint8_t *in, std::size_t len, char *out) noexcept {
+            const std::size_t n = len / 3 * 3;
+            for (std::size_t i = 0; i < n; i += 3) {
+                const std::uint32_t v = (std::uint32_t{in[i]} << 16) | (std::uint32_t{in[i + 1]} << 8) | in[i + 2];
+                *out++ = encode_table[(v >> 18) & 0x3F];
+                *out++ = encode_table[(v >> 12) & 0x3F];
+                *out++ = encode_table[(v >> 6) & 0x3F];
+                *out++ = encode_table[v & 0x3F];
+            }
+            return n;
+        }
+
+        // 编码不足三字节的结尾并补 '='
+        inline char *encode_tail(const std::uint8_t *in, std::size_t len, char *out) noexcept {
+            if (len == 0) {
+                return out;
+            }
+            const std::uint32_t v = (std::uint32_t{in[0]} << 16) | (len > 1 ? std::uint32_t{in[1]} << 8 : 0);
+            *out++ = encode_table[(v >> 18) & 0x3F];
+            *out++ = encode_table[(v >> 12) & 0x3F];
+            *out++ = len > 1 ? encode_table[(v >> 6) & 0x3F] : '=';
+            *out++ = '=';
+            return out;
+        }
+
+        // 标量解码，与旧实现逐字符语义一致
+        inline std::uint8_t *decode_scalar(const char *s, std::size_t n, decode_state &st, std::uint8_t *out) noexcept {
+            for (std::size_t i = 0; i < n && !st.done; ++i) {
+                const std::int8_t d = decode_table[static_cast<unsigned char>(s[i])];
+                if (d < 0) {
+                    st.done = d == padding;
+                    continue;
+                }
+                st.val = (st.val << 6) | static_cast<std::uint32_t>(d);
+                st.valb += 6;
+                if (st.valb >= 0) {
+                    *out++ = static_cast<std::uint8_t>((st.val >> st.valb) & 0xFF);
+                    st.valb -= 8;
+                }
+            }
+            return out;
+        }
+
+#ifdef SIMPLEBASE64_X86
+        // SIMD 编解码参考 Muła & Lemire, "Faster Base64 Encoding and Decoding using AVX2 Instructions"
+
+        // 6 比特索引 -> ASCII
+        SIMPLEBASE64_TARGET("ssse3")
+        inline __m128i lookup_ssse3(__m128i indices) {
+            const __m128i shift_lut = _mm_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            __m128i reduced = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            const __m128i less = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+            reduced = _mm_or_si128(reduced, _mm_and_si128(less, _mm_set1_epi8(13)));
+            return _mm_add_epi8(_mm_shuffle_epi8(shift_lut, reduced), indices);
+        }
+
+        // 每 12 字节编码为 16 个字符，读取 16 字节
+        SIMPLEBASE64_TARGET("ssse3")
+        inline std::size_t encode_blocks_ssse3(const std::uint8_t *in, std::size_t len, char *out) {
+            const __m128i shuf = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            std::size_t i = 0;
+            for (; i + 16 <= len; i += 12, out += 16) {
+                __m128i v = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), shuf);
+                const __m128i t0 = _mm_mulhi_epu16(_mm_and_si128(v, _mm_set1_epi32(0x0fc0fc00)),
+                                                   _mm_set1_epi32(0x04000040));
+                const __m128i t1 = _mm_mullo_epi16(_mm_and_si128(v, _mm_set1_epi32(0x003f03f0)),
+                                                   _mm_set1_epi32(0x01000010));
+                v = lookup_ssse3(_mm_or_si128(t0, t1));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), v);
+            }
+            return i + encode_blocks_scalar(in + i, len - i, out);
+        }
+
+        SIMPLEBASE64_TARGET("avx2")
+        inline __m256i lookup_avx2(__m256i indices) {
+            const __m256i shift_lut = _mm256_setr_epi8(
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0,
+                'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+            __m256i reduced = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+            const __m256i less = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+            reduced = _mm256_or_si256(reduced, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+            return _mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, reduced), indices);
+        }
+
+        // 每 24 字节编码为 32 个字符，两个 128 位通道各读取 16 字节（共读取 28 字节）
+        SIMPLEBASE64_TARGET("avx2")
+        inline std::size_t encode_blocks_avx2(const std::uint8_t *in, std::size_t len, char *out) {
+            const __m256i shuf = _mm256_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1,
+                                                 10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+            std::size_t i = 0;
+            for (; i + 28 <= len; i += 24, out += 32) {
+                const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+                const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i + 12));
+                __m256i v = _mm256_shuffle_epi8(_mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1), shuf);
+                const __m256i t0 = _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0fc0fc00)),
+                                                      _mm256_set1_epi32(0x04000040));
+                const __m256i t1 = _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003f03f0)),
+                                                      _mm256_set1_epi32(0x01000010));
+                v = lookup_avx2(_mm256_or_si256(t0, t1));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), v);
+            }
+            return i + encode_blocks_ssse3(in + i, len - i, out);
+        }
+
+        // 每 16 个字符解码为 12 字节（写出 16 字节），遇到含非 Base64 字符的块即停止，返回消耗的字符数
+        SIMPLEBASE64_TARGET("ssse3")
+        inline std::size_t decode_blocks_ssse3(const char *s, std::size_t n, std::uint8_t *out) {
+            const __m128i lut_lo = _mm_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m128i lut_hi = _mm_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m128i lut_roll = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16, out += 12) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+                const __m128i hi_nibbles = _mm_and_si128(_mm_srli_epi32(v, 4), _mm_set1_epi8(0x0f));
+                const __m128i lo_nibbles = _mm_and_si128(v, _mm_set1_epi8(0x0f));
+                const __m128i lo = _mm_shuffle_epi8(lut_lo, lo_nibbles);
+                const __m128i hi = _mm_shuffle_epi8(lut_hi, hi_nibbles);
+                if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lo, hi), _mm_setzero_si128())) != 0xFFFF) {
+                    break;
+                }
+                const __m128i eq_2f = _mm_cmpeq_epi8(v, _mm_set1_epi8(0x2f));
+                const __m128i roll = _mm_shuffle_epi8(lut_roll, _mm_add_epi8(eq_2f, hi_nibbles));
+                __m128i values = _mm_add_epi8(v, roll);
+                values = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+                values = _mm_madd_epi16(values, _mm_set1_epi32(0x00011000));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out), _mm_shuffle_epi8(values, pack));
+            }
+            return i;
+        }
+
+        // 每 32 个字符解码为 24 字节（写出 32 字节）
+        SIMPLEBASE64_TARGET("avx2")
+        inline std::size_t decode_blocks_avx2(const char *s, std::size_t n, std::uint8_t *out) {
+            const __m256i lut_lo = _mm256_setr_epi8(
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A,
+                0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const __m256i lut_hi = _mm256_setr_epi8(
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const __m256i lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                                                      0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+            const __m256i pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                                                  2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+            const __m256i permute = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, -1, -1);
+
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32, out += 24) {
+                const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+                const __m256i hi_nibbles = _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0f));
+                const __m256i lo_nibbles = _mm256_and_si256(v, _mm256_set1_epi8(0x0f));
+                const __m256i lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+                const __m256i hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+                if (!_mm256_testz_si256(lo, hi)) {
+                    break;
+                }
+                const __m256i eq_2f = _mm256_cmpeq_epi8(v, _mm256_set1_epi8(0x2f));
+                const __m256i roll = _mm256_shuffle_epi8(lut_roll, _mm256_add_epi8(eq_2f, hi_nibbles));
+                __m256i values = _mm256_add_epi8(v, roll);
+                values = _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+                values = _mm256_madd_epi16(values, _mm256_set1_epi32(0x00011000));
+                values = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(values, pack), permute);
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(out), values);
+            }
+            return i + decode_blocks_ssse3(s + i, n - i, out);
+        }
+#endif
+
+        enum class simd_level {
+            scalar,
+            ssse3,
+            avx2,
+        };
+
+        inline simd_level detect_simd() noexcept {
+#ifdef SIMPLEBASE64_X86
+    #if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 1);
+            const bool ssse3 = (info[2] & (1 << 9)) != 0;
+            const bool osxsave_avx = (info[2] & (1 << 27)) && (info[2] & (1 << 28)) && (_xgetbv(0) & 6) == 6;
+            __cpuidex(info, 7, 0);
+            const bool avx2 = osxsave_avx && (info[1] & (1 << 5)) != 0;
+    #else
+            __builtin_cpu_init();
+            const bool ssse3 = __builtin_cpu_supports("ssse3");
+            const bool avx2 = __builtin_cpu_supports("avx2");
+    #endif
+            if (avx2) {
+                return simd_level::avx2;
+            }
+            if (ssse3) {
+                return simd_level::ssse3;
+            }
+#endif
+            return simd_level::scalar;
+        }
+
+        inline simd_level active_simd() noexcept {
+            static const simd_level level = detect_simd();
+            return level;
+        }
+
+        // 编码全部完整的三字节组，返回消耗的字节数
+        inline std::size_t encode_blocks(const std::uint8_t *in, std::size_t len, char *out) {
+#ifdef SIMPLEBASE64_X86
+            switch (active_simd()) {
+            case simd_level::avx2: return encode_blocks_avx2(in, len, out);
+            case simd_level::ssse3: return encode_blocks_ssse3(in, len, out);
+            default: break;
+            }
+#endif
+            return encode_blocks_scalar(in, len, out);
+        }
+
+        // SIMD 解码时每个块最多多写出的字节数，输出缓冲区需预留
+        inline constexpr std::size_t decode_slack = 8;
+
+        // 解码一段文本；状态对齐在字符组边界时先走 SIMD 快速路径，其余交给标量实现
+        inline std::uint8_t *decode_into(const char *s, std::size_t n, decode_state &st, std::uint8_t *out) {
+            if (st.done) {
+                return out;
+            }
+#ifdef SIMPLEBASE64_X86
+            if (st.valb == -8) {
+                std::size_t used = 0;
+                switch (active_simd()) {
+                case simd_level::avx2: used = decode_blocks_avx2(s, n, out); break;
+                case simd_level::ssse3: used = decode_blocks_ssse3(s, n, out); break;
+                default: break;
+                }
+                out += used / 4 * 3;
+                s += used;
+                n -= used;
+            }
+#endif
+            return decode_scalar(s, n, st, out);
+        }
+
+    } // namespace detail
 
     // 编码
     inline std::string encode(const std::uint8_t* data, std::size_t len) {
-        std::string ret;
-        ret.reserve((len + 2) / 3 * 4);
-        int val = 0, valb = -6;
-        for (std::size_t i = 0; i < len; ++i) {
-            val = (val << 8) + data[i];
-            valb += 8;
-            while (valb >= 0) {
-                ret.push_back(base64_chars[(val >> valb) & 0x3F]);
-                valb -= 6;
-            }
-        }
-        if (valb > -6)
-            ret.push_back(base64_chars[((val << 8) >> (valb + 8)) & 0x3F]);
-        while (ret.size() % 4)
-            ret.push_back('=');
+        std::string ret((len + 2) / 3 * 4, '\0');
+        const std::size_t used = detail::encode_blocks(data, len, ret.data());
+        detail::encode_tail(data + used, len - used, ret.data() + used / 3 * 4);
         return ret;
     }
 
     inline std::string encode(const std::vector<std::uint8_t>& data) { return encode(data.data(), data.size()); }
 
     // 解码
-    inline std::vector<std::uint8_t> decode(const std::string& str) {
-        std::vector<std::uint8_t> ret;
-        std::vector<int> T(256, -1);
-        for (int i = 0; i < 64; i++)
-            T[static_cast<unsigned char>(base64_chars[i])] = i;
-
-        int val = 0, valb = -8;
-        for (unsigned char c : str) {
-            if (T[c] == -1) {
-                if (c == '=')
-                    break; // padding
-                else
-                    continue; // skip invalid chars
-            }
-            val = (val << 6) + T[c];
-            valb += 6;
-            if (valb >= 0) {
-                ret.push_back(std::uint8_t((val >> valb) & 0xFF));
-                valb -= 8;
-            }
-        }
+    inline std::vector<std::uint8_t> decode(std::string_view str) {
+        std::vector<std::uint8_t> ret(str.size() / 4 * 3 + 3 + detail::decode_slack);
+        detail::decode_state st;
+        const auto *end = detail::decode_into(str.data(), str.size(), st, ret.data());
+        ret.resize(static_cast<std::size_t>(end - ret.data()));
         return ret;
     }
 
+    /**
+     * @brief 流式编码器：分段输入原始数据，每次输出已凑满三字节组的编码结果
+     *
+     * @code
+     * SimpleBase64::Encoder enc;
+     * std::string out;
+     * while (auto n = read(buf)) enc.update(buf, n, out);
+     * enc.finish(out);
+     * @endcode
+     */
+    class Encoder {
+    public:
+        /**
+         * @brief 编码一段数据并追加到 out，不足三字节的结尾留到下次
+         * @note 已知总长度时可预先 out.reserve((total + 2) / 3 * 4)
+         */
+        void update(const std::uint8_t* data, std::size_t len, std::string& out) {
+            if (len == 0) {
+                return;
+            }
+            // 先凑满上次遗留的三字节组
+            while (pending_ != 0 && pending_ < 3 && len != 0) {
+                buf_[pending_++] = *data++;
+                --len;
+            }
+            if (pending_ == 3) {
+                char quad[4];
+                detail::encode_blocks_scalar(buf_, 3, quad);
+                out.append(quad, 4);
+                pending_ = 0;
+            }
+
+            const std::size_t base = out.size();
+            out.resize(base + len / 3 * 4);
+            const std::size_t used = detail::encode_blocks(data, len, out.data() + base);
+            for (std::size_t i = used; i < len; ++i) {
+                buf_[pending_++] = data[i];
+            }
+        }
+
+        /**
+         * @brief 输出剩余数据与 '=' 填充，之后可重新开始编码
+         */
+        void finish(std::string& out) {
+            char quad[4];
+            const char *end = detail::encode_tail(buf_, pending_, quad);
+            out.append(quad, static_cast<std::size_t>(end - quad));
+            pending_ = 0;
+        }
+
+    private:
+        std::uint8_t buf_[3]{};
+        std::size_t pending_ = 0;
+    };
+
+    /**
+     * @brief 流式解码器：分段输入编码文本，结果与对完整文本调用 decode 相同
+     */
+    class Decoder {
+    public:
+        /**
+         * @brief 解码一段文本并追加到 out
+         */
+        void update(std::string_view text, std::vector<std::uint8_t>& out) {
+            const std::size_t base = out.size();
+            out.resize(base + text.size() / 4 * 3 + 3 + detail::decode_slack);
+            const auto *end = detail::decode_into(text.data(), text.size(), state_, out.data() + base);
+            out.resize(static_cast<std::size_t>(end - out.data()));
+        }
+
+        /**
+         * @brief 是否已遇到 '='，之后的输入将被忽略
+         */
+        [[nodiscard]] bool done() const noexcept { return state_.done; }
+
+        /**
+         * @brief 重置状态以解码新的内容
+         */
+        void reset() noexcept { state_ = {}; }
+
+    private:
+        detail::decode_state state_;
+    };
+
 } // namespace SimpleBase64
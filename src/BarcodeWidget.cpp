@@ -1,6 +1,9 @@
 #include "BarcodeWidget.h"
 #include "LanguageManager.h"
 #include "about_dialog.h"
+#include "components/PayloadView.h"
+#include "components/ResultView.h"
+#include "components/TiledImageView.h"
 #include "components/UiConfig.h"
 #include "components/message_dialog.h"
 #include "convert.h"
@@ -16,6 +19,8 @@
 #include <QHBoxLayout>
 #include <QLabel>
 #include <QLineEdit>
+#include <QListView>
+#include <QLocale>
 #include <QMenu>
 #include <QMenuBar>
 #include <QMessageBox>
@@ -24,6 +29,9 @@
 #include <QProgressBar>
 #include <QPushButton>
 #include <QScrollArea>
+#include <QStackedWidget>
+#include <QStandardPaths>
+#include <QTimer>
 #include <QtConcurrent>
 #include <SimpleBase64.h>
 #include <ZXing/BarcodeFormat.h>
@@ -115,7 +123,7 @@ void drawIcon(QPainter &p, bool isImage, bool isText) {
 static QRegularExpression fileExtensionRegex_text(R"(^.*\.(?:txt|json|rfa)$)",
                                                   QRegularExpression::CaseInsensitiveOption);
 
-static QRegularExpression fileExtensionRegex_image(R"(^.*\.(?:png|jpg|jpeg|bmp|gif|tiff|webp)$)",
+static QRegularExpression fileExtensionRegex_image(R"(^.*\.(?:png|jpg|jpeg|bmp|gif|tif|tiff|webp)$)",
                                                    QRegularExpression::CaseInsensitiveOption);
 
 BarcodeWidget::BarcodeWidget(QWidget *parent)
@@ -140,15 +148,53 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     base64CheckAcion->setCheckable(true);
     base64CheckAcion->setChecked(true); // 默认勾选
 
+    // 二进制模式直接以字节模式写入原始数据，不经过Base64，默认不勾选
+    binaryAction = new QAction(tr("二进制模式"), this);
+    binaryAction->setCheckable(true);
+    binaryAction->setChecked(false);
+
+    // 压缩有收益时先压缩再编码，压缩级别见配置文件，默认不勾选
+    compressAction = new QAction(tr("压缩"), this);
+    compressAction->setCheckable(true);
+    compressAction->setChecked(false);
+
     directTextAction = new QAction(tr("文本输入"), this);
     directTextAction->setCheckable(true);
     directTextAction->setChecked(false); // 默认不勾选
 
+    // 内容超过单个条码容量时拆分为多张条码，默认不勾选
+    chunkAction = new QAction(tr("分块生成"), this);
+    chunkAction->setCheckable(true);
+    chunkAction->setChecked(false);
+
+    // 批量处理时每个结果生成后立即写入选择的目录，只保留缩略图，默认不勾选
+    streamAction = new QAction(tr("边处理边保存"), this);
+    streamAction->setCheckable(true);
+    streamAction->setChecked(false);
+
     helpMenu->addAction(aboutAction);
     toolsMenu->addAction(debugMqttAction);
     toolsMenu->addAction(openCameraScanAction);
     settingMenu->addAction(base64CheckAcion);
+    settingMenu->addAction(binaryAction);
+    settingMenu->addAction(compressAction);
     settingMenu->addAction(directTextAction);
+    settingMenu->addAction(chunkAction);
+    settingMenu->addAction(streamAction);
+
+    // 条码的保存格式：SVG/PDF 直接由模块矩阵生成，任意缩放打印都保持锐利，默认 PNG
+    saveFormatMenu = settingMenu->addMenu(tr("保存格式"));
+    auto *saveFormatGroup = new QActionGroup(this);
+    saveFormatGroup->setExclusive(true);
+    pngFormatAction = new QAction("PNG", this);
+    svgFormatAction = new QAction(tr("SVG（矢量）"), this);
+    pdfFormatAction = new QAction(tr("PDF（矢量）"), this);
+    for (QAction *action : {pngFormatAction, svgFormatAction, pdfFormatAction}) {
+        action->setCheckable(true);
+        saveFormatGroup->addAction(action);
+        saveFormatMenu->addAction(action);
+    }
+    pngFormatAction->setChecked(true);
 
     // 连接菜单项的点击信号
     connect(aboutAction, &QAction::triggered, this, &BarcodeWidget::showAbout);
@@ -210,14 +256,120 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     progressBar->setValue(0);
     progressBar->setTextVisible(true); // 显示百分比文字
     progressBar->setVisible(false);    // 默认隐藏，只有批量处理时才显示
-    mainLayout->addWidget(progressBar);
+
+    // 暂停时不再开始新的任务，取消后已完成的结果照常展示
+    pauseButton = new QPushButton(tr("暂停"), this);
+    pauseButton->setObjectName("pauseButton");
+    pauseButton->setVisible(false);
+    cancelButton = new QPushButton(tr("取消"), this);
+    cancelButton->setObjectName("cancelButton");
+    cancelButton->setVisible(false);
+
+    // 批处理结束后在进度条的位置显示耗时，悬停显示各阶段的分位数
+    timingLabel = new QLabel(this);
+    timingLabel->setObjectName("timingLabel");
+    timingLabel->setVisible(false);
+
+    QHBoxLayout *progressLayout = new QHBoxLayout();
+    progressLayout->addWidget(progressBar, 1);
+    progressLayout->addWidget(timingLabel, 1);
+    progressLayout->addWidget(pauseButton);
+    progressLayout->addWidget(cancelButton);
+    mainLayout->addLayout(progressLayout);
+
+    // 批处理中的结果合并后定时刷新，不为每个结果重建一次展示区域
+    renderTimer = new QTimer(this);
+    renderTimer->setSingleShot(true);
+    renderTimer->setInterval(300);
 
     // 图片展示区域
     scrollArea = new QScrollArea(this);
     scrollArea->setObjectName("scrollArea");
     scrollArea->setWidgetResizable(true);
     scrollArea->setMinimumHeight(320);
-    mainLayout->addWidget(scrollArea);
+
+    // 文件列表与多个结果用模型/视图展示，只绘制可见的行与单元格，文件再多也不会创建大量控件
+    fileListModel = new FileListModel(this);
+    fileListView = new QListView(this);
+    fileListView->setObjectName("fileListView");
+    fileListView->setModel(fileListModel);
+    fileListView->setItemDelegate(new FileRowDelegate(fileListView));
+    fileListView->setUniformItemSizes(true);
+    fileListView->setSpacing(3);
+    fileListView->setMouseTracking(true);
+    fileListView->setSelectionMode(QAbstractItemView::NoSelection);
+    fileListView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+
+    fileListHeader = new QLabel(this);
+    fileListHeader->setObjectName("headerLabel");
+    fileListPage = new QWidget(this);
+    fileListPage->setObjectName("resultContainer");
+    QVBoxLayout *fileListLayout = new QVBoxLayout(fileListPage);
+    fileListLayout->setContentsMargins(10, 10, 10, 10);
+    fileListLayout->addWidget(fileListHeader);
+    fileListLayout->addWidget(fileListView, 1);
+
+    resultModel = new ResultListModel(
+        [](const convert::result_data_entry &entry) {
+            QString fileNameStr = QFileInfo(entry.source_file_name).fileName();
+            if (fileNameStr.isEmpty()) {
+                fileNameStr = "Unknown";
+            }
+            // 同一张图中识别到的多个条码，标出序号与格式
+            if (entry.symbol_count > 0) {
+                fileNameStr +=
+                    QString(" #%1 %2").arg(entry.symbol_index).arg(barcodeFormatToString(entry.barcode_format));
+            }
+            return fileNameStr;
+        },
+        this);
+    resultView = new QListView(this);
+    resultView->setObjectName("resultView");
+    resultView->setViewMode(QListView::IconMode);
+    resultView->setResizeMode(QListView::Adjust);
+    resultView->setMovement(QListView::Static);
+    resultView->setUniformItemSizes(true);
+    resultView->setSpacing(10);
+    resultView->setSelectionMode(QAbstractItemView::NoSelection);
+    resultView->setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    resultView->setModel(resultModel);
+    resultView->setItemDelegate(new ResultGridDelegate(resultView));
+
+    resultStack = new QStackedWidget(this);
+    resultStack->setMinimumHeight(320);
+    resultStack->addWidget(scrollArea);
+    resultStack->addWidget(fileListPage);
+    resultStack->addWidget(resultView);
+
+    imageView = new TiledImageView(this);
+    imageView->setObjectName("imageView");
+    resultStack->addWidget(imageView);
+
+    // 解码内容直接从字节缓冲区按行显示，可在十六进制与文本之间切换
+    payloadView = new PayloadView(this);
+    payloadView->setObjectName("payloadView");
+    payloadInfoLabel = new QLabel(this);
+    payloadInfoLabel->setObjectName("headerLabel");
+    hexModeButton = new QPushButton(tr("十六进制"), this);
+    hexModeButton->setCheckable(true);
+    textModeButton = new QPushButton(tr("文本"), this);
+    textModeButton->setCheckable(true);
+    textModeButton->setAutoExclusive(true);
+    hexModeButton->setAutoExclusive(true);
+    hexModeButton->setChecked(true);
+
+    QHBoxLayout *payloadHeader = new QHBoxLayout();
+    payloadHeader->addWidget(payloadInfoLabel, 1);
+    payloadHeader->addWidget(hexModeButton);
+    payloadHeader->addWidget(textModeButton);
+    payloadPage = new QWidget(this);
+    payloadPage->setObjectName("resultContainer");
+    QVBoxLayout *payloadLayout = new QVBoxLayout(payloadPage);
+    payloadLayout->setContentsMargins(10, 10, 10, 10);
+    payloadLayout->addLayout(payloadHeader);
+    payloadLayout->addWidget(payloadView, 1);
+    resultStack->addWidget(payloadPage);
+    mainLayout->addWidget(resultStack);
 
     QWidget *configWidget = new QWidget(this);
     configWidget->setObjectName("configWidget");
@@ -227,6 +379,20 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     configMainLayout->setVerticalSpacing(10);
 
     imageSizeConfig = ImageSizeConfig::loadFromConfig("./setting/config.json");
+    codecConfig = CodecConfig::loadFromConfig("./setting/config.json");
+    // 批处理读写文件的线程，与编码/识别的计算线程分开
+    convert::io_pool().setMaxThreadCount(codecConfig.io_threads);
+
+    // 重复生成同样的内容时直接使用缓存的图片
+    const auto cacheConfig = CacheConfig::loadFromConfig("./setting/config.json");
+    convert::image_cache::instance().configure(
+        {.memory_budget = cacheConfig.memory_mb << 20, .spill_dir = QString::fromStdString(cacheConfig.spill_dir)});
+    // 重复解码同样的图片时直接使用上次的结果，重启程序后依然有效
+    if (cacheConfig.decode_cache) {
+        convert::decode_cache::instance().configure(
+            {.dir = QDir(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation)).filePath("decode_cache"),
+             .byte_budget = cacheConfig.decode_cache_mb << 20});
+    }
 
     formatLabel = new QLabel(tr("条码类型:"), this);
     formatLabel->setObjectName("configLabel");
@@ -234,7 +400,7 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     formatLabel->setMinimumWidth(100);
     formatLabel->setAlignment(Qt::AlignRight | Qt::AlignVCenter);
 
-    QComboBox *formatComboBox = new QComboBox(this);
+    formatComboBox = new QComboBox(this);
     formatComboBox->setObjectName("formatComboBox");
     formatComboBox->setFont(Ui::getAppFont(11));
     formatComboBox->setFixedWidth(200);
@@ -327,6 +493,26 @@ BarcodeWidget::BarcodeWidget(QWidget *parent)
     connect(generateButton, &QPushButton::clicked, this, &BarcodeWidget::onGenerateClicked);
     connect(decodeToChemFile, &QPushButton::clicked, this, &BarcodeWidget::onDecodeToChemFileClicked);
     connect(saveButton, &QPushButton::clicked, this, &BarcodeWidget::onSaveClicked);
+    connect(pauseButton, &QPushButton::clicked, this, [this] {
+        if (batchWatcher == nullptr) {
+            return;
+        }
+        batchWatcher->setPaused(!batchWatcher->isPaused());
+        pauseButton->setText(batchWatcher->isPaused() ? tr("继续") : tr("暂停"));
+    });
+    connect(cancelButton, &QPushButton::clicked, this, [this] {
+        if (batchWatcher == nullptr) {
+            return;
+        }
+        // 进行中的任务完成后 watcher 发出 finished，在那里展示已完成的结果
+        batchWatcher->cancel();
+        pauseButton->setEnabled(false);
+        cancelButton->setEnabled(false);
+    });
+    connect(renderTimer, &QTimer::timeout, this, &BarcodeWidget::showNewResults);
+    connect(payloadView, &PayloadView::analyzed, this, &BarcodeWidget::updatePayloadInfo);
+    connect(hexModeButton, &QPushButton::clicked, this, [this] { payloadView->setMode(PayloadView::Hex); });
+    connect(textModeButton, &QPushButton::clicked, this, [this] { payloadView->setMode(PayloadView::Text); });
     connect(filePathEdit, &QLineEdit::textChanged, this, [this](const QString &text) {
         lastResults.clear();
         lastSelectedFiles = text.split(QDir::listSeparator());
@@ -466,8 +652,15 @@ void BarcodeWidget::onGenerateClicked() {
     const auto targetHeight = imageSizeConfig.getTargetHeightPixels();
     const auto targePPI = imageSizeConfig.ppi;
 
-    const auto useBase64 = base64CheckAcion->isChecked();
-    const auto format = currentBarcodeFormat;
+    const convert::encode_options options{
+        .qrcode = {.target_width = targetWidth, .target_height = targetHeight, .format = currentBarcodeFormat},
+        .ppi = targePPI,
+        .use_base64 = base64CheckAcion->isChecked(),
+        .binary = binaryAction->isChecked(),
+        .compress = compressAction->isChecked(),
+        .compression_level = codecConfig.compression_level,
+        .chunk_size = chunkAction->isChecked() ? codecConfig.chunk_size : 0,
+    };
 
     if (directTextAction->isChecked()) {
         QString rawText = filePathEdit->text();
@@ -480,23 +673,11 @@ void BarcodeWidget::onGenerateClicked() {
         QStringList inputs;
         inputs.append(rawText);
 
-        // 准备 UI
-        progressBar->setVisible(true);
-        progressBar->setRange(0, 1);
-        progressBar->setValue(0);
-        generateButton->setEnabled(false);
-        saveButton->setEnabled(false);
-        this->setCursor(Qt::WaitCursor);
-
         // 定义处理文本的 Worker
         struct TextWorker {
             using result_type = convert::result_data_entry;
 
-            bool useBase64;
-            convert::QRcode_create_config config;
-            int finalWidth;  // 最终目标宽度
-            int finalHeight; // 最终目标高度
-            int targePPI;
+            convert::encode_options options;
 
             convert::result_data_entry operator()(const QString &textInput) const {
                 convert::result_data_entry res;
@@ -505,33 +686,14 @@ void BarcodeWidget::onGenerateClicked() {
                 res.source_file_name = "raw_text_input";
 
                 try {
-                    std::string content;
-                    if (useBase64) {
-                        // 如果勾选了 Base64，先将输入文本转为 UTF-8 字节流，再 Base64 编码
-                        QByteArray data = textInput.toUtf8();
-                        content =
-                            SimpleBase64::encode(reinterpret_cast<const std::uint8_t *>(data.constData()), data.size());
-                    } else {
-                        content = textInput.toStdString();
-                    }
-
-                    auto img = convert::byte_to_QRCode_qimage(content, config);
-                    spdlog::info("生成二维码图片，尺寸: {}x{}", img.width(), img.height());
-                    spdlog::info("参数宽高: {}x{}", finalWidth, finalWidth);
+                    auto symbol = convert::encode_bytes(textInput.toUtf8(), options);
+                    const QImage &img = symbol.image;
+                    spdlog::info(
+                        "生成二维码图片，尺寸: {}x{}, 设置密度: {} DPI", img.width(), img.height(), options.ppi);
 
                     if (!img.isNull()) {
-                        // 缩放图像到精确尺寸
-                        img = convert::resizeImageToExactSize(img, finalWidth, finalHeight);
-
-                        int ppi = targePPI;
-                        int dpm = static_cast<int>(ppi / 0.0254);
-                        img.setDotsPerMeterX(dpm);
-                        img.setDotsPerMeterY(dpm);
-
-                        spdlog::info(
-                            "缩放后图片尺寸: {}x{}, 设置密度: {} DPI ({} DPM)", img.width(), img.height(), ppi, dpm);
-
                         res.data = img;
+                        res.vector = std::move(symbol.vector);
                         // 图片设置到剪贴板当中
                         QImage copyImg = img;
 
@@ -556,18 +718,11 @@ void BarcodeWidget::onGenerateClicked() {
             }
         };
 
-        auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
-        connect(watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] {
-            onBatchFinish(*watcher);
-        });
+        auto *watcher = createBatchWatcher();
+        beginBatch(watcher, inputs.size());
 
         // 启动异步任务
-        watcher->setFuture(QtConcurrent::mapped(
-            inputs,
-            TextWorker{
-                useBase64, {targetWidth, targetHeight, format},
-                 targetWidth, targetHeight, targePPI
-        }));
+        watcher->setFuture(QtConcurrent::mapped(inputs, TextWorker{options}));
 
         return; // 结束函数，不再执行下方的文件处理逻辑
     }
@@ -584,89 +739,31 @@ void BarcodeWidget::onGenerateClicked() {
         QMessageBox::warning(this, tr("警告"), tr("无可处理文件"));
         return;
     }
+    activeStream = chooseStreamOutput();
+    if (activeStream && activeStream->output_dir.isEmpty()) {
+        activeStream.reset();
+        return;
+    }
     // 2. UI 状态准备
-    progressBar->setVisible(true);
-    progressBar->setRange(0, filePaths.size()); // 设置进度条范围
-    progressBar->setValue(0);
-    generateButton->setEnabled(false);
-    decodeToChemFile->setEnabled(false);
-    saveButton->setEnabled(false);
-    this->setCursor(Qt::WaitCursor);
-
-    struct worker {
-        using result_type = convert::result_data_entry;
-        int reqWidth;
-        int reqHeight;
-        int finalWidth;  // 最终目标宽度
-        int finalHeight; // 最终目标高度
-        int targePPI;    // 目标PPI用于设置DPM
-        bool useBase64;
-        ZXing::BarcodeFormat format;
-
-        convert::result_data_entry operator()(const QString &filePath) const {
-            try {
-                QFile file(filePath);
-
-                convert::result_data_entry res;
-                if (!file.open(QIODevice::ReadOnly)) {
-                    res.data = QString(tr("无法打开文件: ")).toStdString() + filePath.toStdString();
-                    res.source_file_name = std::move(filePath);
-                    return res;
-                } else {
-                    res.source_file_name = std::move(filePath);
-                }
-
-                const QByteArray data = file.readAll();
-                file.close();
-
-                // 是否base64处理通过判断base64CheckBox
-                std::string text;
-                if (useBase64) {
-                    text = SimpleBase64::encode(reinterpret_cast<const std::uint8_t *>(data.constData()), data.size());
-                } else {
-                    text = data.toStdString();
-                }
-
-                auto img = convert::byte_to_QRCode_qimage(
-                    text, {.target_width = reqWidth, .target_height = reqHeight, .format = format, .margin = 1});
-
-                if (!img.isNull()) {
-                    // 缩放图像到精确尺寸
-                    img = convert::resizeImageToExactSize(img, finalWidth, finalHeight);
-
-                    // 设置图像DPI/DPM元数据
-                    int ppi = targePPI;
-                    int dpm = static_cast<int>(ppi / 0.0254);
-                    img.setDotsPerMeterX(dpm);
-                    img.setDotsPerMeterY(dpm);
-
-                    res.data = img;
-                } else {
-                    res.data = QString(tr("生成图片失败")).toStdString();
-                }
-
-                return res;
-            } catch (const std::exception &e) {
-                convert::result_data_entry res;
-                res.source_file_name = std::move(filePath);
-                res.data.emplace<std::string>(e.what());
-                return res;
-            }
-        }
-    };
-
-    auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
-
-    connect(watcher,
-            &QFutureWatcher<convert::result_data_entry>::progressValueChanged,
-            progressBar,
-            &QProgressBar::setValue);
-
-    connect(
-        watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] { onBatchFinish(*watcher); });
-
-    watcher->setFuture(QtConcurrent::mapped(
-        filePaths, worker{targetWidth, targetHeight, targetWidth, targetHeight, targePPI, useBase64, format}));
+    auto *watcher = createBatchWatcher();
+    beginBatch(watcher, filePaths.size());
+
+    // 读取与写入在 I/O 线程池中，编码与压缩在全局线程池中，大文件先处理；
+    // 仅启用 Base64 时读取阶段按块流式编码，不在内存中保留完整的原始数据，见 convert::load_encode_input
+    watcher->setFuture(convert::run_pipeline(
+        filePaths,
+        convert::pipeline_stages<QString, convert::loaded_encode_input, convert::result_data_entry>{
+            .cost = [](const QString &path) { return QFileInfo(path).size(); },
+            .load = [options](const QString &path) { return convert::load_encode_input(path, options); },
+            .process =
+                [options, stream = activeStream](const convert::loaded_encode_input &input) {
+                    return convert::stage_result(convert::encode_loaded(input, options), stream);
+                },
+            .write_failed = [](convert::result_data_entry &entry,
+                               const convert::output_file &output) { convert::mark_unsaved(entry, output.path); },
+            .error = [](const QString &path,
+                        const std::exception &e) { return convert::result_data_entry{path, std::string(e.what())}; },
+        }));
 }
 
 void BarcodeWidget::onDecodeToChemFileClicked() {
@@ -675,57 +772,43 @@ void BarcodeWidget::onDecodeToChemFileClicked() {
         QMessageBox::warning(this, tr("警告"), tr("无可处理文件"));
         return;
     }
+    activeStream = chooseStreamOutput();
+    if (activeStream && activeStream->output_dir.isEmpty()) {
+        activeStream.reset();
+        return;
+    }
+    // 多页 TIFF 的每一页是一个任务，各页并行解码
+    const QList<convert::decode_task> tasks = convert::expand_decode_tasks(filePaths);
 
     // 2. UI 状态准备
-    progressBar->setVisible(true);
-    progressBar->setRange(0, filePaths.size()); // 设置进度条范围
-    progressBar->setValue(0);
-    generateButton->setEnabled(false);
-    decodeToChemFile->setEnabled(false);
-    saveButton->setEnabled(false);
-    this->setCursor(Qt::WaitCursor);
-
-    struct worker {
-        using result_type = convert::result_data_entry;
-
-        bool useBase64;
-        convert::result_data_entry operator()(QString path) const {
-            try {
-                const auto file_path = path.toLocal8Bit().toStdString();
-                switch (auto rst = convert::QRcode_to_byte(file_path); rst.err) {
-                case convert::result_i2t::empty_img:
-                    spdlog::error("cv::imread 无法加载图片文件: {}", path.toStdString());
-                    return {std::move(path), QString{tr("无法加载图片文件: %1")}.arg(path).toStdString()};
-                case convert::result_i2t::invalid_qrcode:
-                    return {std::move(path), QString{tr("无法识别条码或条码格式不正确")}.toStdString()};
-                default:
-                    std::vector<std::uint8_t> decodedData;
-                    if (useBase64) {
-                        decodedData = SimpleBase64::decode(rst.text);
-                    } else {
-                        decodedData = std::vector<std::uint8_t>(rst.text.begin(), rst.text.end());
-                    }
-                    return {std::move(path),
-                            QByteArray(reinterpret_cast<const char *>(decodedData.data()),
-                                       static_cast<int>(decodedData.size()))};
-                }
-            } catch (const std::exception &e) {
-                return {std::move(path), QString("解码失败:\n%1").arg(e.what()).toStdString()};
-            }
-        }
+    auto *watcher = createBatchWatcher();
+    beginBatch(watcher, tasks.size());
+
+    // 优先按当前选择的条码格式快速识别，失败时再逐级放宽，见 convert::QRcode_to_byte
+    const convert::decode_options options{
+        .use_base64 = base64CheckAcion->isChecked(),
+        .reduce_min_edge = codecConfig.decode_reduce_min_edge,
+        .formats = currentBarcodeFormat,
+        .tile_size = codecConfig.decode_tile_size,
+        .multi_symbol = codecConfig.decode_multi_symbol,
     };
-
-    auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
-
-    connect(watcher,
-            &QFutureWatcher<convert::result_data_entry>::progressValueChanged,
-            progressBar,
-            &QProgressBar::setValue);
-
-    connect(
-        watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] { onBatchFinish(*watcher); });
-
-    watcher->setFuture(QtConcurrent::mapped(filePaths, worker{base64CheckAcion->isChecked()}));
+    // 读取与写入在 I/O 线程池中，识别在全局线程池中，大文件先处理
+    watcher->setFuture(convert::run_pipeline(
+        tasks,
+        convert::pipeline_stages<convert::decode_task, convert::loaded_decode_task, convert::result_data_entry>{
+            .cost = [](const convert::decode_task &task) { return QFileInfo(task.path).size(); },
+            .load = convert::load_decode_task,
+            .process =
+                [options, stream = activeStream](const convert::loaded_decode_task &loaded) {
+                    return convert::stage_result(convert::decode_loaded(loaded, options), stream);
+                },
+            .write_failed = [](convert::result_data_entry &entry,
+                               const convert::output_file &output) { convert::mark_unsaved(entry, output.path); },
+            .error =
+                [](const convert::decode_task &task, const std::exception &e) {
+                    return convert::result_data_entry{task.source_name(), std::string(e.what())};
+                },
+        }));
 }
 
 void BarcodeWidget::onSaveClicked() {
@@ -755,12 +838,15 @@ void BarcodeWidget::onSaveClicked() {
     if (lastResults.size() == 1) {
         const auto &entry = lastResults.front();
 
-        const QString defName = entry.get_default_target_name();
+        const QString suffix = imageSaveSuffix();
+        const QString defName = entry.get_default_target_name(suffix);
         auto fileName = std::visit<QString>(
             overload_def_noop{std::in_place_type<QString>,
                               [&](const QImage &) {
-                                  return QFileDialog::getSaveFileName(
-                                      this, tr("保存图片"), defName, "PNG Images (*.png)");
+                                  const QString filter = suffix == "svg"   ? "SVG Images (*.svg)"
+                                                         : suffix == "pdf" ? "PDF Documents (*.pdf)"
+                                                                           : "PNG Images (*.png)";
+                                  return QFileDialog::getSaveFileName(this, tr("保存图片"), defName, filter);
                               },
                               [&](const QByteArray &) {
                                   return QFileDialog::getSaveFileName(
@@ -784,12 +870,13 @@ void BarcodeWidget::onSaveClicked() {
         }
 
         const QDir outputDir(dir);
+        const QString suffix = imageSaveSuffix();
         for (const auto &entry : lastResults) {
             if (!entry) {
                 continue;
             }
 
-            const QString fileName = outputDir.filePath(entry.get_default_target_name());
+            const QString fileName = outputDir.filePath(entry.get_default_target_name(suffix));
             tasks.append({entry, std::move(fileName)});
         }
     }
@@ -798,54 +885,30 @@ void BarcodeWidget::onSaveClicked() {
         return;
     }
 
-    progressBar->setVisible(true);
-    progressBar->setRange(0, tasks.size());
-    progressBar->setValue(0);
-    saveButton->setEnabled(false);
-    generateButton->setEnabled(false);
-    decodeToChemFile->setEnabled(false);
-    this->setCursor(Qt::WaitCursor);
-
-    struct worker {
-        using result_type = SaveResult;
-        SaveResult operator()(const SaveTask &task) const noexcept try {
-            return std::visit<SaveResult>(
-                overload_def_noop{std::in_place_type<SaveResult>,
-                                  [&](const QImage &img) -> SaveResult {
-                                      if (img.isNull()) {
-                                          return {SaveResult::invalid_data, task.dest};
-                                      }
-                                      if (img.save(task.dest)) {
-                                          return {SaveResult::success, task.dest};
-                                      } else {
-                                          return {SaveResult::failed, task.dest};
-                                      }
-                                  },
-                                  [&](const QByteArray &data) -> SaveResult {
-                                      if (data.isEmpty()) {
-                                          return {SaveResult::invalid_data, task.dest};
-                                      }
-
-                                      QFile f(task.dest);
-                                      if (f.open(QIODevice::WriteOnly)) {
-                                          f.write(data);
-                                          f.close();
-                                          return {SaveResult::success, task.dest};
-                                      }
-                                      return {SaveResult::failed, task.dest};
-                                  },
-                                  [&](const auto &) noexcept { return SaveResult{SaveResult::failed, task.dest}; }},
-                task.entry.data);
-        } catch (...) { return {SaveResult::failed}; }
+    // 编码（PNG 压缩、生成 SVG/PDF）在全局线程池中，写入在 I/O 线程池中
+    struct encoder {
+        int pngLevel; /**< PNG 压缩级别 */
+
+        convert::staged_result<SaveResult> operator()(const SaveTask &task) const noexcept try {
+            const bool empty = std::visit(overload_def_noop{std::in_place_type<bool>,
+                                                            [](const QImage &img) { return img.isNull(); },
+                                                            [](const QByteArray &data) { return data.isEmpty(); }},
+                                          task.entry.data);
+            if (empty) {
+                return {{SaveResult::invalid_data, task.dest}};
+            }
+            auto data = convert::encode_entry(task.entry, task.dest, pngLevel);
+            if (!data) {
+                return {{SaveResult::failed, task.dest}};
+            }
+            return {{SaveResult::success, task.dest}, {{task.dest, *std::move(data)}}};
+        } catch (...) { return {{SaveResult::failed, task.dest}}; }
     };
 
     auto *watcher = new QFutureWatcher<SaveResult>(this);
 
-    connect(watcher, &QFutureWatcher<SaveResult>::progressValueChanged, progressBar, &QProgressBar::setValue);
-
     connect(watcher, &QFutureWatcher<SaveResult>::finished, [this, watcher]() {
-        this->setCursor(Qt::ArrowCursor);
-        progressBar->setVisible(false);
+        endBatch();
 
         // 恢复按钮状态
         updateButtonStates();
@@ -878,11 +941,18 @@ void BarcodeWidget::onSaveClicked() {
             }
         }
 
+        const auto timing =
+            finishTiming(list.size(), list.isEmpty() ? QString() : QFileInfo(list.front().path).absolutePath());
+
         // 构建消息框内容
         QString msg = QString(tr("操作完成。\n总计处理: %1\n成功: %2\n失败: %3"))
                           .arg(list.size())
                           .arg(successCount)
                           .arg(failedInfos.size());
+        if (watcher->future().isCanceled()) {
+            msg += tr("\n\n保存已取消，其余文件没有保存。");
+        }
+        msg += tr("\n\n[耗时]:\n") + timing.report();
 
         if (!failedInfos.isEmpty()) {
             msg += tr("\n\n[保存失败的文件]:\n");
@@ -905,8 +975,22 @@ void BarcodeWidget::onSaveClicked() {
 
         watcher->deleteLater();
     });
-
-    watcher->setFuture(QtConcurrent::mapped(tasks, worker{}));
+    beginBatch(watcher, tasks.size());
+
+    watcher->setFuture(convert::run_pipeline(
+        tasks,
+        convert::pipeline_stages<SaveTask, SaveTask, SaveResult>{
+            .cost =
+                [](const SaveTask &task) {
+                    const auto *img = std::get_if<QImage>(&task.entry.data);
+                    const auto *data = std::get_if<QByteArray>(&task.entry.data);
+                    return img ? img->sizeInBytes() : data ? data->size() : 0;
+                },
+            .process = encoder{codecConfig.png_compression_level},
+            .write_failed = [](SaveResult &res, const convert::output_file &) { res.err = SaveResult::failed; },
+            .error = [](const SaveTask &task,
+                        const std::exception &) { return SaveResult{SaveResult::failed, task.dest}; },
+        }));
 }
 
 void BarcodeWidget::showAbout() const {
@@ -941,6 +1025,33 @@ QImage BarcodeWidget::MatToQImage(const cv::Mat &mat) const {
 }
 
 void BarcodeWidget::renderResults() const {
+    if (lastResults.empty() && !directTextAction->isChecked() && !lastSelectedFiles.empty()) {
+        renderSelectedFiles();
+        return;
+    }
+    if (lastResults.size() > 1) {
+        // 多个结果以网格展示，缩略图在单元格可见时才在后台生成
+        resultModel->setEntries(lastResults);
+        resultStack->setCurrentWidget(resultView);
+        return;
+    }
+    if (lastResults.size() == 1) {
+        if (const auto *img = std::get_if<QImage>(&lastResults.front().data); img != nullptr && !img->isNull()) {
+            // 大图分块显示，可缩放、拖动，不会把整张图转换为 QPixmap
+            imageView->setImage(*img);
+            imageView->setToolTip(QString("Size: %1x%2").arg(img->width()).arg(img->height()));
+            resultStack->setCurrentWidget(imageView);
+            return;
+        }
+        if (const auto *bytes = std::get_if<QByteArray>(&lastResults.front().data)) {
+            // 内容可能有几 MB 或是二进制，不交给 QLabel 排版，只绘制可见的行
+            payloadView->setData(*bytes);
+            updatePayloadInfo();
+            resultStack->setCurrentWidget(payloadPage);
+            return;
+        }
+    }
+
     QWidget *container = new QWidget();
     container->setObjectName("resultContainer");
 
@@ -951,91 +1062,17 @@ void BarcodeWidget::renderResults() const {
         infoLabel->setAlignment(Qt::AlignCenter);
         vLayout->addWidget(infoLabel);
         scrollArea->setWidget(container);
+        resultStack->setCurrentWidget(scrollArea);
         return;
     }
 
-    constexpr int maxColumns = 4; // 每行最多4个 (仅用于多结果)
-
     if (lastResults.empty()) {
-        if (!lastSelectedFiles.empty()) {
-            QVBoxLayout *listLayout = new QVBoxLayout(container);
-            listLayout->setContentsMargins(10, 10, 10, 10);
-            listLayout->setAlignment(Qt::AlignTop);
-
-            QLabel *headerLabel = new QLabel(QString(tr("已选择 %1 个文件，准备处理:")).arg(lastSelectedFiles.size()));
-            headerLabel->setObjectName("headerLabel");
-            listLayout->addWidget(headerLabel);
-
-            for (const QString &filePath : lastSelectedFiles) {
-                QFileInfo fi(filePath);
-                QString fileName = fi.fileName();
-
-                // 判断文件类型以决定图标和操作提示
-                bool isText = fileExtensionRegex_text.match(fileName).hasMatch();
-                bool isImage = fileExtensionRegex_image.match(fileName).hasMatch();
-
-                // 创建单行容器 Widget
-                QWidget *rowWidget = new QWidget();
-                rowWidget->setObjectName("fileRowWidget");
-
-                QHBoxLayout *rowLayout = new QHBoxLayout(rowWidget);
-                rowLayout->setContentsMargins(10, 8, 10, 8);
-                rowLayout->setSpacing(12);
-
-                // 1. 图标 Label
-                QLabel *iconLabel = new QLabel();
-                iconLabel->setObjectName("fileIconLabel");
-                iconLabel->setFixedSize(24, 24);
-
-                // 2. 使用 QPainter 绘制动态图标 (避免依赖外部图片资源)
-                QPixmap iconPix(24, 24);
-                iconPix.fill(Qt::transparent);
-                {
-                    QPainter p(&iconPix);
-                    p.setRenderHint(QPainter::Antialiasing);
-
-                    drawIcon(p, isImage, isText);
-                }
-                iconLabel->setPixmap(iconPix);
-
-                // 3. 文件名
-                QLabel *nameLabel = new QLabel(fileName);
-                nameLabel->setObjectName("fileNameLabel");
-                nameLabel->setToolTip(filePath); // 鼠标悬停显示完整路径
-
-                // 4. 类型/操作提示标签
-                QLabel *typeLabel = new QLabel();
-                typeLabel->setObjectName("fileTypeLabel");
-
-                if (isImage) {
-                    typeLabel->setText(tr("[待解码]"));
-                    typeLabel->setProperty("status", "decode");
-                } else if (isText) {
-                    typeLabel->setText(tr("[待生成]"));
-                    typeLabel->setProperty("status", "generate");
-                } else {
-                    typeLabel->setText(tr("[不确定类型，默认待生成]"));
-                    typeLabel->setProperty("status", "unknown");
-                }
-
-                // 布局添加
-                rowLayout->addWidget(iconLabel);
-                rowLayout->addWidget(nameLabel, 1); // 这里的 1 代表拉伸因子，让文件名占据主要空间
-                rowLayout->addWidget(typeLabel);
-
-                listLayout->addWidget(rowWidget);
-            }
-            // 底部弹簧，确保列表靠上
-            listLayout->addStretch();
-
-        } else {
-            // 无文件选中且无结果
-            QVBoxLayout *vLayout = new QVBoxLayout(container);
-            QLabel *emptyLabel = new QLabel(tr("请选择文件\n或者键入内容"));
-            emptyLabel->setObjectName("emptyLabel");
-            emptyLabel->setAlignment(Qt::AlignCenter);
-            vLayout->addWidget(emptyLabel);
-        }
+        // 无文件选中且无结果
+        QVBoxLayout *vLayout = new QVBoxLayout(container);
+        QLabel *emptyLabel = new QLabel(tr("请选择文件\n或者键入内容"));
+        emptyLabel->setObjectName("emptyLabel");
+        emptyLabel->setAlignment(Qt::AlignCenter);
+        vLayout->addWidget(emptyLabel);
     } else if (lastResults.size() == 1) {
         // --- 单个结果展示逻辑 (保持原样) ---
         const auto &entry = lastResults.front();
@@ -1047,31 +1084,14 @@ void BarcodeWidget::renderResults() const {
 
         std::visit(overload_def_noop{
                        std::in_place_type<void>,
-                       [&](const QImage &img) {
-                           QLabel *imgLabel = new QLabel();
+                       // 有内容的图片由 imageView 显示，这里只剩流式保存后没有保留的图片
+                       [&](const QImage &) {
+                           QLabel *imgLabel =
+                               new QLabel(tr("已保存:\n%1").arg(QFileInfo(entry.saved_path).fileName()));
                            imgLabel->setObjectName("imageLabel");
-                           imgLabel->setPixmap(QPixmap::fromImage(img));
                            imgLabel->setAlignment(Qt::AlignCenter);
-                           imgLabel->setToolTip(QString("Size: %1x%2").arg(img.width()).arg(img.height()));
-
-                           // [修改] 将最小尺寸设置为图片尺寸，确保大图能撑开 ScrollArea 出现滚动条
-                           imgLabel->setMinimumSize(img.size());
-
                            contentWidget = imgLabel;
                        },
-                       [&](const QByteArray &data) {
-                           QLabel *textLabel = new QLabel();
-                           textLabel->setObjectName("textLabel");
-                           // 显示完整解码内容
-                           QString textDisplay = QString::fromUtf8(data);
-
-                           textLabel->setText(textDisplay);
-                           textLabel->setWordWrap(true);
-
-                           textLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-                           textLabel->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Preferred); // 允许内容撑开
-                           contentWidget = textLabel;
-                       },
                        [&](const std::string &str) {
                            QLabel *errLabel = new QLabel(QString::fromStdString(str));
                            errLabel->setObjectName("errorLabel");
@@ -1086,99 +1106,77 @@ void BarcodeWidget::renderResults() const {
         if (contentWidget) {
             singleLayout->addWidget(contentWidget, 1); // 权重设为 1 占据空间
         }
-    } else {
-        // --- 多个结果网格展示逻辑 (保持原样) ---
-        QGridLayout *gridLayout = new QGridLayout(container);
-        gridLayout->setHorizontalSpacing(20);
-        gridLayout->setVerticalSpacing(40);
-        gridLayout->setContentsMargins(20, 20, 20, 20);
-
-        int count = 0;
-
-        for (const auto &entry : lastResults) {
-            int row = count / maxColumns;
-            int col = count % maxColumns;
-
-            QWidget *cellWidget = new QWidget();
-            QVBoxLayout *cellLayout = new QVBoxLayout(cellWidget);
-            cellLayout->setContentsMargins(0, 0, 0, 0);
-            cellLayout->setSpacing(5);
-
-            QWidget *contentWidget = nullptr;
-
-            std::visit(overload_def_noop{std::in_place_type<void>,
-                                         // 图片类型，显示缩略图
-                                         [&](const QImage &img) {
-                                             QLabel *imgLabel = new QLabel();
-                                             imgLabel->setObjectName("imageLabel");
-                                             // 使用缩略图大小 200x200
-                                             imgLabel->setPixmap(QPixmap::fromImage(img).scaled(
-                                                 200, 200, Qt::KeepAspectRatio, Qt::SmoothTransformation));
-                                             imgLabel->setAlignment(Qt::AlignCenter);
-                                             imgLabel->setToolTip(
-                                                 QString("Size: %1x%2").arg(img.width()).arg(img.height()));
-                                             contentWidget = imgLabel;
-                                         },
-                                         // 文本类型，显示前200字符 (截断)
-                                         [&](const QByteArray &data) {
-                                             QLabel *textLabel = new QLabel();
-                                             textLabel->setObjectName("gridTextLabel");
-                                             QString textDisplay = QString::fromUtf8(data);
-                                             if (textDisplay.length() > 256) {
-                                                 textDisplay = textDisplay.left(256) + "...";
-                                             }
-                                             textLabel->setText(textDisplay);
-                                             textLabel->setWordWrap(true);
-
-                                             textLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-                                             textLabel->setFixedSize(200, 200);
-                                             contentWidget = textLabel;
-                                         },
-                                         // 错误信息，显示解码或生成的错误内容
-                                         [&](const std::string &str) {
-                                             QLabel *errLabel = new QLabel(QString::fromStdString(str));
-                                             errLabel->setObjectName("gridErrorLabel");
-                                             errLabel->setWordWrap(true);
-
-                                             errLabel->setAlignment(Qt::AlignTop | Qt::AlignLeft);
-
-                                             errLabel->setFixedSize(200, 200);
-                                             contentWidget = errLabel;
-                                         }},
-                       entry.data);
-
-            if (contentWidget) {
-                // 仅在多结果模式下渲染文件名
-                QString fileNameStr = QFileInfo(entry.source_file_name).fileName();
-                if (fileNameStr.isEmpty()) {
-                    fileNameStr = "Unknown";
-                }
-
-                QLabel *nameLabel = new QLabel(fileNameStr);
-                nameLabel->setObjectName("resultNameLabel");
-                nameLabel->setAlignment(Qt::AlignCenter);
-                nameLabel->setFixedWidth(200);
-                nameLabel->setToolTip(entry.source_file_name);
+    }
 
-                QFontMetrics metrics(nameLabel->font());
-                QString elidedText = metrics.elidedText(fileNameStr, Qt::ElideMiddle, 200);
-                nameLabel->setText(elidedText);
+    scrollArea->setWidget(container);
+    resultStack->setCurrentWidget(scrollArea);
+}
 
-                cellLayout->addWidget(nameLabel);
+void BarcodeWidget::renderSelectedFiles() const {
+    // 三种图标各绘制一次，所有行共享
+    const auto makeIcon = [](bool isImage, bool isText) {
+        QPixmap iconPix(24, 24);
+        iconPix.fill(Qt::transparent);
+        QPainter p(&iconPix);
+        p.setRenderHint(QPainter::Antialiasing);
+        drawIcon(p, isImage, isText);
+        p.end();
+        return QIcon(iconPix);
+    };
+    const QIcon imageIcon = makeIcon(true, false);
+    const QIcon textIcon = makeIcon(false, true);
+    const QIcon unknownIcon = makeIcon(false, false);
+    const QColor readyColor("#67C23A");
+    const QColor unknownColor("#E6A23C");
+
+    QVector<FileListModel::Row> rows;
+    rows.reserve(lastSelectedFiles.size());
+    for (const QString &filePath : lastSelectedFiles) {
+        const QString fileName = QFileInfo(filePath).fileName();
+
+        // 判断文件类型以决定图标和操作提示
+        const bool isText = fileExtensionRegex_text.match(fileName).hasMatch();
+        const bool isImage = fileExtensionRegex_image.match(fileName).hasMatch();
+        if (isImage) {
+            rows.append({filePath, imageIcon, tr("[待解码]"), readyColor});
+        } else if (isText) {
+            rows.append({filePath, textIcon, tr("[待生成]"), readyColor});
+        } else {
+            rows.append({filePath, unknownIcon, tr("[不确定类型，默认待生成]"), unknownColor});
+        }
+    }
 
-                cellLayout->addWidget(contentWidget);
+    fileListHeader->setText(QString(tr("已选择 %1 个文件，准备处理:")).arg(lastSelectedFiles.size()));
+    fileListModel->setRows(std::move(rows));
+    resultStack->setCurrentWidget(fileListPage);
+}
 
-                gridLayout->addWidget(cellWidget, row, col, Qt::AlignTop);
-            }
-            count++;
-        }
+void BarcodeWidget::updatePayloadInfo() const {
+    const QString size = QLocale().formattedDataSize(payloadView->size());
+    if (!payloadView->isAnalyzed()) {
+        payloadInfoLabel->setText(tr("%1，正在分析内容…").arg(size));
+    } else if (payloadView->isBinary()) {
+        payloadInfoLabel->setText(tr("%1，二进制内容").arg(size));
+    } else {
+        payloadInfoLabel->setText(tr("%1，UTF-8 文本").arg(size));
     }
+    hexModeButton->setEnabled(payloadView->isAnalyzed());
+    textModeButton->setEnabled(payloadView->isAnalyzed());
+    (payloadView->mode() == PayloadView::Hex ? hexModeButton : textModeButton)->setChecked(true);
+}
 
-    scrollArea->setWidget(container);
+void BarcodeWidget::showNewResults() {
+    // 网格已在展示本批结果时只追加新到达的结果，保留滚动位置
+    const auto shown = static_cast<std::size_t>(resultModel->rowCount());
+    if (resultStack->currentWidget() == resultView && shown > 1 && shown <= lastResults.size()) {
+        resultModel->append(lastResults.cbegin() + static_cast<std::ptrdiff_t>(shown), lastResults.cend());
+    } else {
+        renderResults();
+    }
 }
 
 void BarcodeWidget::onBatchFinish(QFutureWatcher<convert::result_data_entry> &watcher) {
-    setCursor(Qt::ArrowCursor);
+    endBatch();
     if (lastSelectedFiles.size() == 1) {
         auto &file = lastSelectedFiles.front();
         bool isImage = fileExtensionRegex_image.match(file).hasMatch();
@@ -1189,24 +1187,125 @@ void BarcodeWidget::onBatchFinish(QFutureWatcher<convert::result_data_entry> &wa
         decodeToChemFile->setEnabled(true);
     }
 
-    progressBar->setVisible(false);
-
+    // 结果到达的顺序不固定，换成按输入顺序排列的完整结果
     QList<convert::result_data_entry> results = watcher.future().results();
+    if (watcher.future().isCanceled()) {
+        spdlog::info("批处理已取消，已完成 {} 个", results.size());
+    }
+    const int completed = results.size();
 
     lastResults.clear();
     lastResults.reserve(results.size());
     for (auto &item : results) {
         lastResults.push_back(std::move(item));
     }
+    // 分块生成的多张条码逐张展示；解码得到的分块按文件重组
+    convert::flatten_results(lastResults);
+    const QString tiers = convert::log_decode_tiers(lastResults);
+    convert::reassemble_chunks(lastResults, base64CheckAcion->isChecked());
+    convert::image_cache::instance().log_stats();
+    convert::decode_cache::instance().log_stats();
+
+    // 流式保存时各结果已在工作线程中写入，只剩重组得到的内容需要写入
+    if (activeStream) {
+        int saved = 0;
+        for (auto &entry : lastResults) {
+            if (entry.saved_path.isEmpty() && std::holds_alternative<QByteArray>(entry.data)) {
+                entry = convert::stream_result(std::move(entry), *activeStream);
+            }
+            saved += entry.saved_path.isEmpty() ? 0 : 1;
+        }
+        spdlog::info("已写入 {} 个文件到 {}", saved, activeStream->output_dir.toStdString());
+    }
+    finishTiming(completed, activeStream ? activeStream->output_dir : QString(), tiers);
 
     if (!lastResults.empty()) {
-        saveButton->setEnabled(true);
+        // 流式保存的结果只剩缩略图，不能再次保存
+        saveButton->setEnabled(!activeStream);
         renderResults(); // 批量渲染结果
     }
+    activeStream.reset();
 
     watcher.deleteLater();
 }
 
+void BarcodeWidget::onBatchResultsReady(QFutureWatcher<convert::result_data_entry> &watcher, int begin, int end) {
+    std::vector<convert::result_data_entry> ready;
+    ready.reserve(end - begin);
+    for (int i = begin; i < end; ++i) {
+        ready.push_back(watcher.resultAt(i));
+    }
+    convert::flatten_results(ready);
+    std::ranges::move(ready, std::back_inserter(lastResults));
+    if (!renderTimer->isActive()) {
+        renderTimer->start();
+    }
+}
+
+QFutureWatcher<convert::result_data_entry> *BarcodeWidget::createBatchWatcher() {
+    lastResults.clear();
+    renderResults();
+
+    auto *watcher = new QFutureWatcher<convert::result_data_entry>(this);
+    connect(watcher,
+            &QFutureWatcher<convert::result_data_entry>::resultsReadyAt,
+            this,
+            [this, watcher](int begin, int end) { onBatchResultsReady(*watcher, begin, end); });
+    connect(
+        watcher, &QFutureWatcher<convert::result_data_entry>::finished, [this, watcher] { onBatchFinish(*watcher); });
+    return watcher;
+}
+
+void BarcodeWidget::beginBatch(QFutureWatcherBase *watcher, int total) {
+    batchWatcher = watcher;
+    connect(watcher, &QFutureWatcherBase::progressValueChanged, progressBar, &QProgressBar::setValue);
+
+    progressBar->setRange(0, total);
+    progressBar->setValue(0);
+    progressBar->setVisible(true);
+    timingLabel->setVisible(false);
+    pauseButton->setText(tr("暂停"));
+    pauseButton->setEnabled(true);
+    pauseButton->setVisible(true);
+    cancelButton->setEnabled(true);
+    cancelButton->setVisible(true);
+
+    generateButton->setEnabled(false);
+    decodeToChemFile->setEnabled(false);
+    saveButton->setEnabled(false);
+    setCursor(Qt::WaitCursor);
+    convert::stage_timings::instance().begin();
+}
+
+void BarcodeWidget::endBatch() {
+    batchWatcher = nullptr;
+    renderTimer->stop();
+    progressBar->setVisible(false);
+    pauseButton->setVisible(false);
+    cancelButton->setVisible(false);
+    setCursor(Qt::ArrowCursor);
+}
+
+convert::batch_timing BarcodeWidget::finishTiming(int files, const QString &outputDir, const QString &tiers) {
+    const auto timing = convert::stage_timings::instance().finish(files);
+    timing.log("批处理");
+    if (codecConfig.timing_json && !outputDir.isEmpty()) {
+        const QString path = QDir(outputDir).filePath(convert::timing_file_name);
+        if (!convert::write_file(path, timing.to_json())) {
+            spdlog::warn("无法写入耗时汇总: {}", path.toStdString());
+        }
+    }
+    if (tiers.isEmpty()) {
+        timingLabel->setText(timing.summary_line());
+        timingLabel->setToolTip(timing.report());
+    } else {
+        timingLabel->setText(timing.summary_line() + "；" + tiers);
+        timingLabel->setToolTip(tiers + '\n' + timing.report());
+    }
+    timingLabel->setVisible(true);
+    return timing;
+}
+
 template <>
 struct magic_enum::customize::enum_range<ZXing::BarcodeFormat> {
     static constexpr bool is_flags = true;
@@ -1239,6 +1338,33 @@ ZXing::BarcodeFormat BarcodeWidget::stringToBarcodeFormat(const QString &formatS
     return map.value(key, ZXing::BarcodeFormat::None); // 未匹配时返回None
 }
 
+QString BarcodeWidget::imageSaveSuffix() const {
+    if (svgFormatAction->isChecked()) {
+        return "svg";
+    }
+    if (pdfFormatAction->isChecked()) {
+        return "pdf";
+    }
+    return "png";
+}
+
+std::optional<convert::stream_options> BarcodeWidget::chooseStreamOutput() {
+    if (!streamAction->isChecked()) {
+        return std::nullopt;
+    }
+    convert::stream_options stream{
+        .output_dir = QFileDialog::getExistingDirectory(
+            this,
+            tr("请选择保存文件夹"),
+            QStandardPaths::writableLocation(QStandardPaths::DocumentsLocation),
+            QFileDialog::ShowDirsOnly | QFileDialog::DontResolveSymlinks),
+        .image_suffix = imageSaveSuffix(),
+        .level = codecConfig.png_compression_level,
+        .thumbnails = std::make_shared<std::atomic<int>>(convert::default_stream_thumbnails),
+    };
+    return stream;
+}
+
 void BarcodeWidget::setupLanguageAction() {
     LanguageManager &languageMgr = LanguageManager::instance();
 
@@ -1277,12 +1403,24 @@ void BarcodeWidget::retranslate() {
     debugMqttAction->setText(tr("MQTT实时消息监控窗口"));
     openCameraScanAction->setText(tr("打开摄像头扫码"));
     base64CheckAcion->setText(tr("Base64"));
+    binaryAction->setText(tr("二进制模式"));
+    compressAction->setText(tr("压缩"));
     directTextAction->setText(tr("文本输入"));
+    chunkAction->setText(tr("分块生成"));
+    streamAction->setText(tr("边处理边保存"));
+    saveFormatMenu->setTitle(tr("保存格式"));
+    svgFormatAction->setText(tr("SVG（矢量）"));
+    pdfFormatAction->setText(tr("PDF（矢量）"));
     filePathEdit->setPlaceholderText(tr("选择一个文件或图片"));
     browseButton->setText(tr("浏览"));
     generateButton->setText(tr("生成"));
     decodeToChemFile->setText(tr("解码"));
     saveButton->setText(tr("保存"));
+    hexModeButton->setText(tr("十六进制"));
+    textModeButton->setText(tr("文本"));
+    updatePayloadInfo();
+    pauseButton->setText(batchWatcher != nullptr && batchWatcher->isPaused() ? tr("继续") : tr("暂停"));
+    cancelButton->setText(tr("取消"));
     generateButton->setToolTip(tr("请选择任意文件来生成条码"));
     decodeToChemFile->setToolTip(tr("可以解码PNG图片中的条码"));
     formatLabel->setText(tr("条码类型:"));
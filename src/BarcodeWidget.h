@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <vector>
 
 #include <QWidget>
@@ -8,6 +9,8 @@
 #include <qfuturewatcher.h>
 
 #include "CameraWidget.h"
+#include "components/CacheConfig.h"
+#include "components/CodecConfig.h"
 #include "components/ImageSizeConfig.h"
 #include "convert.h"
 #include "mqtt/MQTTMessageWidget.h"
@@ -17,10 +20,17 @@ class QLineEdit;
 class QPushButton;
 class QLabel;
 class QScrollArea;
+class QStackedWidget;
+class QListView;
+class ResultListModel;
+class FileListModel;
+class TiledImageView;
+class PayloadView;
 class QCheckBox;
 class QComboBox;
 class QFileDialog;
 class QProgressBar;
+class QTimer;
 class QMenuBar;
 
 /**
@@ -101,12 +111,35 @@ private slots:
     */
     void renderResults() const;
 
+    /**
+    * @brief 展示已选择、等待处理的文件列表
+    */
+    void renderSelectedFiles() const;
+
+    /**
+    * @brief 批处理中定时展示新到达的结果：结果网格只追加新行，其他情况重新渲染
+    */
+    void showNewResults();
+
+    /**
+    * @brief 刷新解码内容查看器上方的大小、类型与显示方式
+    */
+    void updatePayloadInfo() const;
+
     /**
     * @brief 批处理完成回调函数
     * @param watcher 异步任务监视器
     */
     void onBatchFinish(QFutureWatcher<convert::result_data_entry> &watcher);
 
+    /**
+    * @brief 批处理中有新结果到达时回调，结果立即加入展示
+    * @param watcher 异步任务监视器
+    * @param begin 新结果的起始下标
+    * @param end 新结果的结束下标（不含）
+    */
+    void onBatchResultsReady(QFutureWatcher<convert::result_data_entry> &watcher, int begin, int end);
+
     /**
      * @brief 将条码格式枚举转换为字符串表示。
      *
@@ -129,6 +162,43 @@ private:
      */
     void setupLanguageAction();
 
+    /**
+     * @brief 当前选择的条码保存格式
+     * @return 文件扩展名：png、svg 或 pdf
+     */
+    [[nodiscard]] QString imageSaveSuffix() const;
+
+    /**
+     * @brief 启用了流式保存时，让用户选择输出目录
+     * @return 未启用流式保存时返回 std::nullopt；用户取消时返回 output_dir 为空的设置
+     */
+    [[nodiscard]] std::optional<convert::stream_options> chooseStreamOutput();
+
+    /**
+     * @brief 创建批处理的异步任务监视器：结果陆续到达时展示，全部结束后调用 onBatchFinish
+     */
+    [[nodiscard]] QFutureWatcher<convert::result_data_entry> *createBatchWatcher();
+
+    /**
+     * @brief 批处理开始：显示进度条与暂停/取消按钮，禁用生成、解码与保存
+     * @param watcher 本次批处理的监视器，暂停与取消作用于它
+     * @param total 任务数
+     */
+    void beginBatch(QFutureWatcherBase *watcher, int total);
+
+    /**
+     * @brief 批处理结束（完成或已取消）：隐藏进度条与暂停/取消按钮
+     */
+    void endBatch();
+
+    /**
+     * @brief 汇总本批各阶段的耗时：输出日志、显示在进度条的位置，配置启用时写入输出目录
+     * @param files 完成的任务数
+     * @param outputDir 结果写入的目录，为空表示没有写出文件
+     * @param tiers 解码批次各层级的识别数量（见 convert::log_decode_tiers），附在耗时概要之后
+     */
+    convert::batch_timing finishTiming(int files, const QString &outputDir, const QString &tiers = {});
+
     /**
      * @brief QEvent::LanguageChange事件发生时调用，用于刷新语言
      */
@@ -157,12 +227,20 @@ private:
     QMenu *toolsMenu;       /**< 工具菜单 */
     QMenu *settingMenu;     /**< 设置菜单 */
     QMenu *languageSubMenu; /**< 语言菜单 */
+    QMenu *saveFormatMenu;  /**< 保存格式菜单 */
 
     QAction *aboutAction;          /**< "关于"操作 */
     QAction *debugMqttAction;      /**< 打开MQTT消息展示窗口 */
     QAction *openCameraScanAction; /**< 启动摄像头扫描条码 */
     QAction *base64CheckAcion;     /**< 启用Base64编码/解码 */
+    QAction *binaryAction;         /**< 启用二进制模式（跳过Base64） */
+    QAction *compressAction;       /**< 启用压缩 */
     QAction *directTextAction;     /**< 启用文本输入*/
+    QAction *chunkAction;          /**< 启用分块生成 */
+    QAction *streamAction;         /**< 启用流式保存（结果生成后立即写入目录） */
+    QAction *pngFormatAction;      /**< 条码保存为 PNG */
+    QAction *svgFormatAction;      /**< 条码保存为 SVG（矢量） */
+    QAction *pdfFormatAction;      /**< 条码保存为 PDF（矢量） */
 
     QLineEdit *filePathEdit;                                                  /**< 文件路径输入框 */
     QPushButton *browseButton;                                                /**< 浏览按钮 */
@@ -176,8 +254,26 @@ private:
     QLabel *unitLabel;                                                        /**< 单位标签 */
     QLabel *ppiLabel;                                                         /**< PPI标签 */
     QProgressBar *progressBar;                                                /**< 异步进度条 */
+    QPushButton *pauseButton;                                                 /**< 暂停/继续批处理按钮 */
+    QPushButton *cancelButton;                                                /**< 取消批处理按钮 */
+    QFutureWatcherBase *batchWatcher = nullptr;                               /**< 正在进行的批处理，没有时为空 */
+    QTimer *renderTimer;                                                      /**< 合并批处理中陆续到达的结果，定时刷新展示 */
+    QLabel *timingLabel;                                                      /**< 上一批的耗时与吞吐量，悬停显示各阶段耗时 */
     std::vector<convert::result_data_entry> lastResults;                      /**< 上次解码结果 */
-    QScrollArea *scrollArea;                                                  /**< 滚动区域 */
+    QScrollArea *scrollArea;                                                  /**< 滚动区域（单个结果与提示） */
+    QStackedWidget *resultStack;                                              /**< 结果展示区域：滚动区域、文件列表或结果网格 */
+    QWidget *fileListPage;                                                    /**< 文件列表页 */
+    QLabel *fileListHeader;                                                   /**< 文件列表标题（文件数） */
+    QListView *fileListView;                                                  /**< 已选择的文件列表 */
+    FileListModel *fileListModel;                                             /**< 已选择的文件 */
+    QListView *resultView;                                                    /**< 多个结果的网格（图标模式） */
+    ResultListModel *resultModel;                                             /**< 网格展示的结果与缩略图缓存 */
+    TiledImageView *imageView;                                                /**< 单个条码图片（分块绘制，可缩放） */
+    QWidget *payloadPage;                                                     /**< 解码内容页 */
+    QLabel *payloadInfoLabel;                                                 /**< 解码内容的大小与类型 */
+    QPushButton *hexModeButton;                                               /**< 以十六进制显示解码内容 */
+    QPushButton *textModeButton;                                              /**< 以文本显示解码内容 */
+    PayloadView *payloadView;                                                 /**< 单个解码内容（按行绘制） */
     QComboBox *formatComboBox;                                                /**< 条码格式选择框 */
     ZXing::BarcodeFormat currentBarcodeFormat = ZXing::BarcodeFormat::QRCode; /**< 当前选择的条码格式 */
     QLineEdit *widthInput;                                                    /**< 图片宽度输入框 */
@@ -189,4 +285,6 @@ private:
     std::unique_ptr<MQTTMessageWidget> messageWidget;                         /**< MQTT消息展示窗口 */
     CameraWidget preview;                                                     /**< 摄像头预览窗口 */
     ImageSizeConfig imageSizeConfig;                                          /**< 图像尺寸配置 */
+    CodecConfig codecConfig;                                                  /**< 编码配置（分块大小、压缩级别等） */
+    std::optional<convert::stream_options> activeStream;                       /**< 当前批处理的流式保存设置，未启用时为空 */
 };
@@ -0,0 +1,155 @@
+#pragma once
+
+#include "envelope.h"
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace convert {
+
+/**
+ * @brief 编译期生成的 CRC-32（IEEE 802.3，与 zlib/PNG 相同）查找表
+ */
+inline constexpr auto crc32_table = [] {
+    std::array<std::uint32_t, 256> table{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}();
+
+/**
+ * @brief 计算 CRC-32，可通过 crc 参数对分段数据连续计算
+ */
+[[nodiscard]] inline std::uint32_t crc32(const void *data, std::size_t len, std::uint32_t crc = 0) noexcept {
+    const auto *p = static_cast<const unsigned char *>(data);
+    crc = ~crc;
+    for (std::size_t i = 0; i < len; ++i) {
+        crc = crc32_table[(crc ^ p[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+[[nodiscard]] inline std::uint32_t crc32(std::string_view data) noexcept {
+    return crc32(data.data(), data.size());
+}
+
+/**
+ * @brief 分块条码中的一个分块
+ *
+ * 每个分块条码的内容为 `\0L2Q|<文件ID>|<序号>/<总数>|<校验>|<数据>`，
+ * 文件ID为完整内容的 CRC-32（十六进制），校验为本分块数据的 CRC-32，序号从 1 开始。
+ * 头部以 NUL 开始（与 envelope 共用 `\0L2Q`），普通文本内容不会被误认为分块。
+ */
+struct chunk_fragment {
+    std::uint32_t file_id = 0; /**< 完整内容的 CRC-32，与总数一起用作分组依据 */
+    int index = 0;             /**< 分块序号，从 1 开始 */
+    int count = 0;             /**< 分块总数 */
+    std::string data;          /**< 分块数据（不含头部） */
+};
+
+inline constexpr std::string_view chunk_magic{"\0L2Q|", 5};
+static_assert(chunk_magic.starts_with(envelope_magic) && chunk_magic.back() == envelope_chunk_marker);
+
+/**
+ * @brief 一个文件最多的分块数，超过时不生成；解码时总数更大的头部视为无效（头部不在分块校验范围内）
+ */
+inline constexpr int max_chunk_count = 65535;
+
+/**
+ * @brief 按 chunk_size 切分 size 字节的内容得到的分块数
+ */
+[[nodiscard]] constexpr std::size_t chunk_count(std::size_t size, std::size_t chunk_size) noexcept {
+    return chunk_size == 0 ? 0 : std::max<std::size_t>(1, (size + chunk_size - 1) / chunk_size);
+}
+
+/**
+ * @brief 内容是否带有分块头部
+ */
+[[nodiscard]] inline bool is_chunk(std::string_view text) noexcept {
+    return text.starts_with(chunk_magic);
+}
+
+/**
+ * @brief 将内容切分为带头部的分块
+ * @param payload 完整内容（Base64 文本或原始字节）
+ * @param chunk_size 每个分块的数据长度（不含头部）
+ */
+[[nodiscard]] inline std::vector<std::string> split_chunks(std::string_view payload, std::size_t chunk_size) {
+    std::vector<std::string> chunks;
+    if (chunk_size == 0) {
+        return chunks;
+    }
+
+    const std::size_t count = chunk_count(payload.size(), chunk_size);
+    const std::uint32_t file_id = crc32(payload);
+    chunks.reserve(count);
+
+    // chunk_magic 以 NUL 开始，不能经过 %s 格式化，单独追加
+    char header[64];
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto data = payload.substr(i * chunk_size, chunk_size);
+        const int len =
+            std::snprintf(header, sizeof(header), "%08x|%zu/%zu|%08x|", file_id, i + 1, count, crc32(data));
+        std::string chunk;
+        chunk.reserve(chunk_magic.size() + static_cast<std::size_t>(len) + data.size());
+        chunk.append(chunk_magic).append(header, static_cast<std::size_t>(len)).append(data);
+        chunks.push_back(std::move(chunk));
+    }
+    return chunks;
+}
+
+/**
+ * @brief 解析分块头部并校验分块数据
+ * @return 头部格式错误、总数超过 max_chunk_count 或校验失败时返回 std::nullopt
+ */
+[[nodiscard]] inline std::optional<chunk_fragment> parse_chunk(std::string_view text) {
+    if (!is_chunk(text)) {
+        return std::nullopt;
+    }
+    text.remove_prefix(chunk_magic.size());
+
+    // 依次读取以 sep 结尾的字段
+    const auto take = [&text](char sep) -> std::optional<std::string_view> {
+        const auto pos = text.find(sep);
+        if (pos == std::string_view::npos) {
+            return std::nullopt;
+        }
+        auto field = text.substr(0, pos);
+        text.remove_prefix(pos + 1);
+        return field;
+    };
+    const auto parse = [](std::optional<std::string_view> field, auto &value, int base) {
+        if (!field || field->empty()) {
+            return false;
+        }
+        const auto [ptr, ec] = std::from_chars(field->data(), field->data() + field->size(), value, base);
+        return ec == std::errc{} && ptr == field->data() + field->size();
+    };
+
+    chunk_fragment fragment;
+    std::uint32_t checksum = 0;
+    if (!parse(take('|'), fragment.file_id, 16) || !parse(take('/'), fragment.index, 10) ||
+        !parse(take('|'), fragment.count, 10) || !parse(take('|'), checksum, 16)) {
+        return std::nullopt;
+    }
+    if (fragment.count < 1 || fragment.count > max_chunk_count || fragment.index < 1 ||
+        fragment.index > fragment.count || crc32(text) != checksum) {
+        return std::nullopt;
+    }
+
+    fragment.data.assign(text);
+    return fragment;
+}
+
+} // namespace convert
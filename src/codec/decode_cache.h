@@ -0,0 +1,222 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QString>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+#include <spdlog/spdlog.h>
+
+namespace convert {
+
+/**
+ * @brief 解码缓存的默认磁盘预算（字节）
+ */
+inline constexpr std::size_t default_decode_cache_budget = std::size_t{256} << 20;
+
+/**
+ * @brief 持久化的解码结果缓存（进程内单例，线程安全）
+ *
+ * 每个结果是一个文件：`<目录>/<解码参数指纹>/<图片内容哈希>.bin`，内容由调用方序列化（见 convert::serialize_decoded）。
+ * 同一份图片以同样的解码参数再次解码时直接读回结果。解码参数是键的一部分，各参数的结果互不影响：
+ * 临时切换格式或 Base64 后再切换回来，原来的结果仍然有效。
+ * 全部指纹目录中结果文件的总大小超过预算时，按修改时间删除最久未使用的结果（命中时更新修改时间），直到降到预算的四分之三。
+ * 目录为空时缓存关闭。
+ */
+class decode_cache {
+public:
+    [[nodiscard]] static decode_cache &instance() {
+        static decode_cache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 缓存设置
+     */
+    struct settings {
+        QString dir;                                           /**< 缓存目录，为空表示关闭 */
+        std::size_t byte_budget = default_decode_cache_budget; /**< 结果文件总大小的上限（字节） */
+    };
+
+    /**
+     * @brief 修改设置
+     */
+    void configure(settings s) {
+        if (!s.dir.isEmpty() && !QDir().mkpath(s.dir)) {
+            spdlog::warn("无法创建解码缓存目录，不使用解码缓存: {}", s.dir.toStdString());
+            s.dir.clear();
+        }
+        spdlog::info("解码缓存目录: \"{}\", 预算 {} MB", s.dir.toStdString(), s.byte_budget >> 20);
+
+        QMutexLocker locker(&mutex_);
+        dir_ = std::move(s.dir);
+        budget_ = s.byte_budget;
+        created_.clear();
+        scanned_ = false;
+    }
+
+    [[nodiscard]] bool enabled() const {
+        QMutexLocker locker(&mutex_);
+        return !dir_.isEmpty();
+    }
+
+    /**
+     * @brief 查找缓存的结果
+     * @param fingerprint 解码参数指纹
+     * @param key 图片内容哈希
+     */
+    [[nodiscard]] std::optional<QByteArray> find(const QByteArray &fingerprint, const QByteArray &key) {
+        const QString dir = result_dir(fingerprint);
+        if (!dir.isEmpty()) {
+            QFile file(entry_path(dir, key));
+            if (file.open(QIODevice::ReadOnly)) {
+                ++hits_;
+                // 修改时间记录最近一次使用，超出预算时最久未使用的结果先被删除
+                file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+                return file.readAll();
+            }
+        }
+        ++misses_;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief 写入结果，先写临时文件再替换，其他线程不会读到写了一半的文件；超出预算时删除最久未使用的结果
+     */
+    void insert(const QByteArray &fingerprint, const QByteArray &key, const QByteArray &blob) {
+        const QString dir = result_dir(fingerprint);
+        if (dir.isEmpty()) {
+            return;
+        }
+        QSaveFile file(entry_path(dir, key));
+        if (!file.open(QIODevice::WriteOnly) || file.write(blob) != blob.size() || !file.commit()) {
+            spdlog::warn("写入解码缓存失败: {}", file.fileName().toStdString());
+            return;
+        }
+
+        QString root;
+        std::size_t budget = 0;
+        {
+            QMutexLocker locker(&mutex_);
+            bytes_ += static_cast<std::size_t>(blob.size());
+            budget = budget_;
+            if (bytes_ <= budget || pruning_) {
+                return;
+            }
+            root = dir_;
+            pruning_ = true;
+        }
+        // 在锁外遍历与删除文件，同一时间只有一个线程清理
+        const std::size_t remaining = prune(root, budget / 4 * 3);
+        QMutexLocker locker(&mutex_);
+        bytes_ = remaining;
+        pruning_ = false;
+    }
+
+    /**
+     * @brief 输出命中/未命中统计
+     */
+    void log_stats() const {
+        if (enabled()) {
+            spdlog::info("解码缓存: 命中 {}, 未命中 {}", hits_.load(), misses_.load());
+        }
+    }
+
+private:
+    decode_cache() = default;
+
+    [[nodiscard]] static QString entry_path(const QString &dir, const QByteArray &key) {
+        return QDir(dir).filePath(QString::fromLatin1(key.toHex()) + ".bin");
+    }
+
+    // 是否是本缓存创建的指纹目录（40 位十六进制），清理时不会误删缓存目录中的其他内容
+    [[nodiscard]] static bool is_fingerprint_dir(const QString &name) {
+        static const QRegularExpression pattern("^[0-9a-f]{40}$");
+        return pattern.match(name).hasMatch();
+    }
+
+    // 全部指纹目录中的结果文件，按修改时间从旧到新排列
+    [[nodiscard]] static QFileInfoList entries(const QString &root) {
+        const QDir rootDir(root);
+        QFileInfoList files;
+        for (const auto &name : rootDir.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+            if (is_fingerprint_dir(name)) {
+                files += QDir(rootDir.filePath(name)).entryInfoList({"*.bin"}, QDir::Files);
+            }
+        }
+        std::stable_sort(files.begin(), files.end(), [](const QFileInfo &a, const QFileInfo &b) {
+            return a.lastModified() < b.lastModified();
+        });
+        return files;
+    }
+
+    // 删除全部指纹目录中最久未使用的结果，直到总大小不超过 target，返回剩余的总大小
+    [[nodiscard]] static std::size_t prune(const QString &root, std::size_t target) {
+        const auto files = entries(root);
+        std::size_t total = 0;
+        for (const auto &info : files) {
+            total += static_cast<std::size_t>(info.size());
+        }
+        int removed = 0;
+        for (const auto &info : files) {
+            if (total <= target) {
+                break;
+            }
+            if (QFile::remove(info.filePath())) {
+                total -= static_cast<std::size_t>(info.size());
+                ++removed;
+            }
+        }
+        spdlog::info("解码缓存超出预算，删除 {} 个最久未使用的结果，剩余 {:.1f} MB",
+                     removed,
+                     static_cast<double>(total) / (1 << 20));
+        return total;
+    }
+
+    // 返回指纹对应的结果目录，不存在时创建；首次使用时统计上次运行留下的全部结果，计入预算
+    [[nodiscard]] QString result_dir(const QByteArray &fingerprint) {
+        QMutexLocker locker(&mutex_);
+        if (dir_.isEmpty()) {
+            return {};
+        }
+        if (!scanned_) {
+            bytes_ = 0;
+            for (const auto &info : entries(dir_)) {
+                bytes_ += static_cast<std::size_t>(info.size());
+            }
+            scanned_ = true;
+        }
+        const QDir root(dir_);
+        const QString name = QString::fromLatin1(fingerprint.toHex());
+        if (!created_.contains(fingerprint)) {
+            if (!root.mkpath(name)) {
+                return {};
+            }
+            created_.insert(fingerprint);
+        }
+        return root.filePath(name);
+    }
+
+    mutable QMutex mutex_;
+    QString dir_;
+    QSet<QByteArray> created_;                         /**< 已确认存在结果目录的解码参数指纹 */
+    std::size_t budget_ = default_decode_cache_budget; /**< 结果文件总大小的上限 */
+    std::size_t bytes_ = 0;                            /**< 全部指纹目录中结果文件的总大小 */
+    bool scanned_ = false;                             /**< 是否已统计缓存目录中已有的结果 */
+    bool pruning_ = false;                             /**< 是否有线程正在清理 */
+
+    std::atomic<quint64> hits_{0};
+    std::atomic<quint64> misses_{0};
+};
+
+} // namespace convert
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace convert {
+
+/**
+ * @brief 自描述的条码内容头部
+ *
+ * 二进制模式下条码内容为 `\0L2Q<flags><数据>`，首字节为 NUL，
+ * 不会与 Base64 文本或普通文本内容混淆，解码时据此自动选择按原始字节读取。
+ * Base64 模式启用压缩时，Base64 编码的是带头部的压缩数据，解码 Base64 后同样据此识别。
+ * 标志字节为 envelope_chunk_marker 的内容是分块条码（见 chunk.h），不是自描述头部。
+ */
+inline constexpr std::string_view envelope_magic{"\0L2Q", 4};
+
+/**
+ * @brief 保留给分块条码的标志字节：分块头部以 `\0L2Q|` 开始，用户的文本内容不会与之混淆
+ */
+inline constexpr char envelope_chunk_marker = '|';
+
+/**
+ * @brief 头部之后紧跟的标志字节
+ */
+enum envelope_flags : std::uint8_t {
+    envelope_none = 0,
+    envelope_deflate = 1 << 0, /**< 数据经 qCompress（zlib/deflate，前4字节为原始长度）压缩 */
+};
+
+/**
+ * @brief 当前版本能够识别的全部标志，出现其他标志位说明内容由更新的版本生成
+ */
+inline constexpr std::uint8_t envelope_known_flags = envelope_deflate;
+
+inline constexpr std::size_t envelope_header_size = envelope_magic.size() + 1;
+
+/**
+ * @brief 内容是否带有自描述头部
+ */
+[[nodiscard]] inline bool is_envelope(std::string_view payload) noexcept {
+    return payload.size() >= envelope_header_size && payload.starts_with(envelope_magic) &&
+           payload[envelope_magic.size()] != envelope_chunk_marker;
+}
+
+/**
+ * @brief 为数据加上头部
+ */
+[[nodiscard]] inline std::string wrap_envelope(std::string_view body, std::uint8_t flags = envelope_none) {
+    std::string payload;
+    payload.reserve(envelope_header_size + body.size());
+    payload.append(envelope_magic).push_back(static_cast<char>(flags));
+    payload.append(body);
+    return payload;
+}
+
+/**
+ * @brief 拆开头部后的内容
+ */
+struct envelope {
+    std::uint8_t flags = envelope_none;
+    std::string_view body;
+};
+
+/**
+ * @brief 拆开头部，内容不带头部时返回 std::nullopt
+ */
+[[nodiscard]] inline std::optional<envelope> unwrap_envelope(std::string_view payload) noexcept {
+    if (!is_envelope(payload)) {
+        return std::nullopt;
+    }
+    return envelope{static_cast<std::uint8_t>(payload[envelope_magic.size()]), payload.substr(envelope_header_size)};
+}
+
+} // namespace convert
@@ -0,0 +1,202 @@
+#pragma once
+
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrent>
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <spdlog/spdlog.h>
+
+namespace convert {
+
+/**
+ * @brief 监视文件夹：新文件写完后立即交给线程池处理
+ *
+ * 目录变化时（QFileSystemWatcher）扫描目录，新文件的大小与修改时间保持 settle_ms 不变、且能以只读方式打开后，
+ * 才认为已写完并进入等待队列，避免处理复制到一半的文件。同时在线程池上处理的文件不超过 max_in_flight 个，
+ * 等待队列不超过 max_queued 个；队列已满时新文件留在目录中，处理完一批后再扫描接收。
+ * 启动时目录中已有的文件同样会被处理；处理过的文件被修改后会再次处理。
+ *
+ * @tparam Result 处理结果，由 work 在线程池中产生，再交给 done 在创建本对象的线程中使用
+ */
+template <typename Result>
+class hot_folder {
+public:
+    /**
+     * @brief 监视设置
+     */
+    struct settings {
+        QString dir;              /**< 监视的目录 */
+        QStringList name_filters; /**< 处理的文件名通配符，为空表示全部文件 */
+        int settle_ms = 1000;     /**< 文件大小与修改时间保持不变多久才认为已写完 */
+        int max_in_flight = 0;    /**< 同时处理的文件数，0 表示线程池的线程数 */
+        int max_queued = 256;     /**< 等待处理的文件数上限 */
+
+        /** 忽略的临时文件（下载、复制过程中的文件） */
+        QStringList ignore_filters{"*.tmp", "*.part", "*.partial", "*.crdownload", "~*"};
+    };
+
+    using work_fn = std::function<Result(const QString &path)>;
+    using done_fn = std::function<void(const QString &path, const Result &result)>;
+
+    hot_folder(settings s, work_fn work, done_fn done)
+        : settings_(std::move(s)), work_(std::move(work)), done_(std::move(done)) {
+        if (settings_.max_in_flight <= 0) {
+            settings_.max_in_flight = std::max(QThreadPool::globalInstance()->maxThreadCount(), 1);
+        }
+        timer_.setInterval(std::max(settings_.settle_ms / 2, 50));
+        QObject::connect(&watcher_, &QFileSystemWatcher::directoryChanged, &timer_, [this] { scan(); });
+        QObject::connect(&timer_, &QTimer::timeout, [this] { scan(); });
+        clock_.start();
+    }
+
+    hot_folder(const hot_folder &) = delete;
+    hot_folder &operator=(const hot_folder &) = delete;
+
+    /**
+     * @brief 开始监视，并接收目录中已有的文件
+     * @return 目录不存在或无法监视时返回 false
+     */
+    bool start() {
+        if (!QFileInfo(settings_.dir).isDir() || !watcher_.addPath(settings_.dir)) {
+            spdlog::error("无法监视目录: {}", settings_.dir.toStdString());
+            return false;
+        }
+        spdlog::info("开始监视目录: {}", settings_.dir.toStdString());
+        scan();
+        return true;
+    }
+
+    /**
+     * @brief 正在处理与等待处理的文件数
+     */
+    [[nodiscard]] int pending() const noexcept {
+        return in_flight_ + static_cast<int>(queue_.size());
+    }
+
+private:
+    /**
+     * @brief 文件的大小与修改时间，两次扫描之间不变表示文件没有在写入
+     */
+    struct stamp {
+        qint64 size = -1;
+        QDateTime modified;
+
+        bool operator==(const stamp &other) const {
+            return size == other.size && modified == other.modified;
+        }
+    };
+
+    struct candidate {
+        stamp last;
+        qint64 stable_since = 0; /**< 开始保持不变的时刻（毫秒） */
+    };
+
+    [[nodiscard]] bool ignored(const QString &name) const {
+        return std::ranges::any_of(settings_.ignore_filters,
+                                   [&](const QString &filter) { return QDir::match(filter, name); });
+    }
+
+    // 扫描目录：记录新文件，已写完的文件放入等待队列
+    void scan() {
+        const qint64 now = clock_.elapsed();
+        const auto entries =
+            QDir(settings_.dir).entryInfoList(settings_.name_filters, QDir::Files, QDir::Time | QDir::Reversed);
+
+        QSet<QString> present;
+        backlog_ = false;
+        for (const auto &info : entries) {
+            const QString path = info.filePath();
+            present.insert(path);
+            if (ignored(info.fileName())) {
+                continue;
+            }
+            const stamp current{info.size(), info.lastModified()};
+            if (const auto it = processed_.constFind(path); it != processed_.cend() && it.value() == current) {
+                continue;
+            }
+
+            auto &c = candidates_[path];
+            if (!(c.last == current)) {
+                c = {current, now};
+                continue;
+            }
+            if (now - c.stable_since < settings_.settle_ms || !QFile(path).open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            if (static_cast<int>(queue_.size()) >= settings_.max_queued) {
+                backlog_ = true;
+                continue;
+            }
+            queue_.push_back(path);
+            processed_.insert(path, current);
+            candidates_.remove(path);
+        }
+
+        // 已删除的文件不再跟踪，同名文件再次出现时重新处理
+        for (auto it = processed_.begin(); it != processed_.end();) {
+            it = present.contains(it.key()) ? std::next(it) : processed_.erase(it);
+        }
+        for (auto it = candidates_.begin(); it != candidates_.end();) {
+            it = present.contains(it.key()) ? std::next(it) : candidates_.erase(it);
+        }
+
+        // 还有文件在写入时继续定时检查，目录不再变化时也能接收
+        if (candidates_.isEmpty()) {
+            timer_.stop();
+        } else if (!timer_.isActive()) {
+            timer_.start();
+        }
+        dispatch();
+    }
+
+    // 把等待队列中的文件交给线程池，同时处理的文件不超过 max_in_flight 个
+    void dispatch() {
+        while (in_flight_ < settings_.max_in_flight && !queue_.empty()) {
+            const QString path = queue_.front();
+            queue_.pop_front();
+            ++in_flight_;
+
+            auto *watcher = new QFutureWatcher<Result>(&timer_);
+            QObject::connect(watcher, &QFutureWatcher<Result>::finished, &timer_, [this, watcher, path] {
+                done_(path, watcher->result());
+                watcher->deleteLater();
+                --in_flight_;
+                if (backlog_) {
+                    scan();
+                } else {
+                    dispatch();
+                }
+            });
+            watcher->setFuture(QtConcurrent::run([work = work_, path] { return work(path); }));
+        }
+    }
+
+    settings settings_;
+    work_fn work_;
+    done_fn done_;
+
+    QFileSystemWatcher watcher_;
+    QTimer timer_; /**< 同时作为各回调的上下文对象，本对象析构后不再回调 */
+    QElapsedTimer clock_;
+
+    QHash<QString, candidate> candidates_; /**< 可能仍在写入的文件 */
+    QHash<QString, stamp> processed_;      /**< 已接收的文件及接收时的状态 */
+    std::deque<QString> queue_;            /**< 等待处理的文件 */
+    int in_flight_ = 0;                    /**< 正在处理的文件数 */
+    bool backlog_ = false;                 /**< 上次扫描时是否因队列已满而留下了文件 */
+};
+
+} // namespace convert
@@ -0,0 +1,231 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDir>
+#include <QFileInfo>
+#include <QHash>
+#include <QImage>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QString>
+#include <atomic>
+#include <cmath>
+#include <list>
+#include <memory>
+#include <optional>
+#include <spdlog/spdlog.h>
+#include <utility>
+#include <vector>
+
+#include "png_writer.h"
+#include "raster.h"
+#include "symbol.h"
+
+namespace convert {
+
+/**
+ * @brief 已生成条码的内容寻址 LRU 缓存（进程内单例，线程安全）
+ *
+ * 键为条码内容与生成参数的哈希（见 convert::image_cache_key），同样的内容以同样的参数再次生成时直接返回缓存的图片。
+ * 内存中的图片总量超过预算时淘汰最久未使用的图片；设置了溢出目录时，被淘汰的条码以 PNG 写入该目录
+ * （图片与每模块 1 像素的模块矩阵各一个文件），之后命中时再读回内存。预算为 0 且没有溢出目录时缓存关闭。
+ */
+class image_cache {
+public:
+    /**
+     * @brief 缓存设置
+     */
+    struct settings {
+        std::size_t memory_budget = 0; /**< 内存预算（字节），0 表示不在内存中保留 */
+        QString spill_dir;             /**< 溢出目录，为空表示不写磁盘 */
+    };
+
+    [[nodiscard]] static image_cache &instance() {
+        static image_cache cache;
+        return cache;
+    }
+
+    /**
+     * @brief 修改设置，超出新预算的图片立即被淘汰
+     */
+    void configure(settings s) {
+        if (!s.spill_dir.isEmpty() && !QDir().mkpath(s.spill_dir)) {
+            spdlog::warn("无法创建缓存溢出目录，不使用磁盘缓存: {}", s.spill_dir.toStdString());
+            s.spill_dir.clear();
+        }
+
+        spdlog::info("图片缓存: 内存预算 {} MB, 溢出目录 \"{}\"", s.memory_budget >> 20, s.spill_dir.toStdString());
+
+        std::vector<entry> evicted;
+        const QString spill_dir = s.spill_dir;
+        {
+            QMutexLocker locker(&mutex_);
+            settings_ = std::move(s);
+            evicted = evict_locked();
+        }
+        spill(evicted, spill_dir);
+    }
+
+    [[nodiscard]] bool enabled() const {
+        QMutexLocker locker(&mutex_);
+        return settings_.memory_budget > 0 || !settings_.spill_dir.isEmpty();
+    }
+
+    /**
+     * @brief 查找缓存，内存未命中时再查溢出目录
+     */
+    [[nodiscard]] std::optional<barcode_symbol> find(const QByteArray &key) {
+        QString spill_file;
+        {
+            QMutexLocker locker(&mutex_);
+            if (const auto it = index_.find(key); it != index_.end()) {
+                lru_.splice(lru_.begin(), lru_, it.value());
+                ++hits_;
+                return lru_.front().second;
+            }
+            if (!settings_.spill_dir.isEmpty()) {
+                spill_file = spill_path(settings_.spill_dir, key);
+            }
+        }
+
+        if (!spill_file.isEmpty()) {
+            if (auto symbol = load_spilled(spill_file)) {
+                ++hits_;
+                ++disk_hits_;
+                insert(key, *symbol);
+                return symbol;
+            }
+        }
+        ++misses_;
+        return std::nullopt;
+    }
+
+    /**
+     * @brief 放入缓存，超出内存预算时淘汰最久未使用的图片
+     */
+    void insert(const QByteArray &key, const barcode_symbol &symbol) {
+        if (symbol.image.isNull() || !symbol.vector) {
+            return;
+        }
+
+        std::vector<entry> evicted;
+        QString spill_dir;
+        {
+            QMutexLocker locker(&mutex_);
+            if (index_.contains(key)) {
+                return;
+            }
+            lru_.emplace_front(key, symbol);
+            index_.insert(key, lru_.begin());
+            bytes_ += size_of(symbol);
+            evicted = evict_locked();
+            spill_dir = settings_.spill_dir;
+        }
+        spill(evicted, spill_dir);
+    }
+
+    /**
+     * @brief 输出命中/未命中统计
+     */
+    void log_stats() const {
+        std::size_t bytes = 0;
+        int count = 0;
+        {
+            QMutexLocker locker(&mutex_);
+            bytes = bytes_;
+            count = index_.size();
+        }
+        spdlog::info("图片缓存: 命中 {}（磁盘 {}）, 未命中 {}, 内存中 {} 张 / {:.1f} MB",
+                     hits_.load(),
+                     disk_hits_.load(),
+                     misses_.load(),
+                     count,
+                     static_cast<double>(bytes) / (1 << 20));
+    }
+
+private:
+    using entry = std::pair<QByteArray, barcode_symbol>;
+
+    image_cache() = default;
+
+    [[nodiscard]] static std::size_t size_of(const barcode_symbol &symbol) {
+        const auto &modules = symbol.vector->modules;
+        return static_cast<std::size_t>(symbol.image.sizeInBytes()) +
+               static_cast<std::size_t>(modules.width()) * static_cast<std::size_t>(modules.height());
+    }
+
+    [[nodiscard]] static QString spill_path(const QString &dir, const QByteArray &key) {
+        return QDir(dir).filePath(QString::fromLatin1(key.toHex()) + ".png");
+    }
+
+    [[nodiscard]] static QString modules_path(const QString &image_path) {
+        return image_path.chopped(4) + ".modules.png";
+    }
+
+    // 读回溢出的条码，图片与模块矩阵缺一不可
+    [[nodiscard]] static std::optional<barcode_symbol> load_spilled(const QString &path) {
+        QImage image;
+        QImage modules;
+        if (!image.load(path, "PNG") || !modules.load(modules_path(path), "PNG")) {
+            return std::nullopt;
+        }
+        const int ppi = static_cast<int>(std::lround(image.dotsPerMeterX() * 0.0254));
+        auto vector = std::make_shared<const vector_symbol>(
+            vector_symbol{modules_from_image(modules), image.width(), image.height(), ppi});
+        return barcode_symbol{std::move(image), std::move(vector)};
+    }
+
+    // 淘汰超出预算的图片，返回需要写入溢出目录的图片
+    [[nodiscard]] std::vector<entry> evict_locked() {
+        std::vector<entry> evicted;
+        while (bytes_ > settings_.memory_budget && !lru_.empty()) {
+            auto &last = lru_.back();
+            bytes_ -= size_of(last.second);
+            index_.remove(last.first);
+            evicted.push_back(std::move(last));
+            lru_.pop_back();
+        }
+        return evicted;
+    }
+
+    // 在锁外写磁盘，避免阻塞其他线程查找
+    static void spill(const std::vector<entry> &evicted, const QString &dir) {
+        if (dir.isEmpty()) {
+            return;
+        }
+        const auto write = [](const QImage &img, const QString &path) {
+            // 先写临时文件再重命名，其他线程不会读到写了一半的文件
+            QSaveFile file(path);
+            if (!file.open(QIODevice::WriteOnly) || !write_png(img, file, 1) || !file.commit()) {
+                spdlog::warn("写入缓存溢出文件失败: {}", path.toStdString());
+                return false;
+            }
+            return true;
+        };
+
+        for (const auto &[key, symbol] : evicted) {
+            const QString path = spill_path(dir, key);
+            if (QFileInfo::exists(path)) {
+                continue;
+            }
+            // 先写模块矩阵，图片文件存在即表示两者都已写好
+            const auto &modules = symbol.vector->modules;
+            if (write(rasterize_bitmatrix(modules, modules.width(), modules.height()), modules_path(path))) {
+                write(symbol.image, path);
+            }
+        }
+    }
+
+    mutable QMutex mutex_;
+    settings settings_;
+    std::list<entry> lru_; /**< 最近使用的在前 */
+    QHash<QByteArray, std::list<entry>::iterator> index_;
+    std::size_t bytes_ = 0;
+
+    std::atomic<quint64> hits_{0};
+    std::atomic<quint64> disk_hits_{0};
+    std::atomic<quint64> misses_{0};
+};
+
+} // namespace convert
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QFile>
+#include <QImageReader>
+#include <QSize>
+#include <QString>
+#include <algorithm>
+#include <opencv2/opencv.hpp>
+
+#include "timing.h"
+
+namespace convert {
+
+/**
+ * @brief 预缩小解码的默认阈值：缩小后的长边不小于该值（像素）时，先以缩小的分辨率识别
+ */
+inline constexpr int default_reduce_min_edge = 1024;
+
+/**
+ * @brief 以只读内存映射打开的图片文件，映射失败（如管道、特殊文件）时退回一次性读取
+ *
+ * 图片的压缩数据直接由 cv::imdecode 从映射区解码，不经过 std::string 路径转换与额外的缓冲区拷贝。
+ */
+class mapped_image_file {
+public:
+    explicit mapped_image_file(const QString &path)
+        : file_(path) {
+        stage_timer timer(batch_stage::read);
+        if (!file_.open(QIODevice::ReadOnly)) {
+            return;
+        }
+        if (file_.size() > 0) {
+            data_ = file_.map(0, file_.size());
+        }
+        if (data_ != nullptr) {
+            size_ = static_cast<std::size_t>(file_.size());
+        } else {
+            fallback_ = file_.readAll();
+            data_ = reinterpret_cast<const uchar *>(fallback_.constData());
+            size_ = static_cast<std::size_t>(fallback_.size());
+        }
+        timer.set_bytes(static_cast<qint64>(size_));
+    }
+
+    mapped_image_file(const mapped_image_file &) = delete;
+    mapped_image_file &operator=(const mapped_image_file &) = delete;
+
+    [[nodiscard]] const uchar *data() const noexcept {
+        return data_;
+    }
+
+    [[nodiscard]] std::size_t size() const noexcept {
+        return size_;
+    }
+
+private:
+    QFile file_; /**< 映射在文件关闭（析构）时自动解除 */
+    QByteArray fallback_;
+    const uchar *data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+/**
+ * @brief 只读取图片头部得到尺寸，不解码像素
+ * @return 格式不支持读取尺寸时返回无效尺寸
+ */
+[[nodiscard]] inline QSize encoded_image_size(const uchar *data, std::size_t size) {
+    QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char *>(data), static_cast<int>(size));
+    QBuffer buffer(&bytes);
+    buffer.open(QIODevice::ReadOnly);
+    return QImageReader(&buffer).size();
+}
+
+/**
+ * @brief 选择预缩小的倍数（1、2、4 或 8），缩小后的长边不小于 min_edge
+ * @param min_edge 为 0 时不缩小
+ */
+[[nodiscard]] inline int reduction_factor(const QSize &size, int min_edge) noexcept {
+    if (min_edge <= 0 || !size.isValid()) {
+        return 1;
+    }
+    const int edge = std::max(size.width(), size.height());
+    int factor = 1;
+    while (factor < 8 && edge / (factor * 2) >= min_edge) {
+        factor *= 2;
+    }
+    return factor;
+}
+
+/**
+ * @brief 将压缩的图片数据直接解码为单通道灰度图
+ * @param factor 缩小倍数（1、2、4 或 8），JPEG 在解码时直接按比例缩小，其他格式解码后缩小
+ * @return 解码失败时返回空矩阵
+ */
+[[nodiscard]] inline cv::Mat decode_grayscale(const uchar *data, std::size_t size, int factor = 1) {
+    if (data == nullptr || size == 0) {
+        return {};
+    }
+    const stage_timer timer(batch_stage::image_decode);
+    int flags = cv::IMREAD_GRAYSCALE;
+    switch (factor) {
+    case 2: flags = cv::IMREAD_REDUCED_GRAYSCALE_2; break;
+    case 4: flags = cv::IMREAD_REDUCED_GRAYSCALE_4; break;
+    case 8: flags = cv::IMREAD_REDUCED_GRAYSCALE_8; break;
+    default: break;
+    }
+    // imdecode 只读取缓冲区，const_cast 仅为满足 cv::Mat 的构造函数
+    const cv::Mat buffer(1, static_cast<int>(size), CV_8UC1, const_cast<uchar *>(data));
+    return cv::imdecode(buffer, flags);
+}
+
+} // namespace convert
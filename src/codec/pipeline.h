@@ -0,0 +1,301 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QFuture>
+#include <QFutureInterface>
+#include <QFutureWatcher>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QString>
+#include <QThreadPool>
+#include <algorithm>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <spdlog/spdlog.h>
+#include <type_traits>
+#include <vector>
+
+#include "timing.h"
+
+namespace convert {
+
+/**
+ * @brief 读写文件的默认线程数
+ */
+inline constexpr int default_io_threads = 4;
+
+/**
+ * @brief 读写文件专用的线程池，与计算使用的全局线程池分开：等待磁盘或网络共享时不占用计算线程
+ */
+[[nodiscard]] inline QThreadPool &io_pool() {
+    // 与 QThreadPool::globalInstance 一样在进程内一直存在，不在退出时析构
+    static QThreadPool *const pool = [] {
+        auto *p = new QThreadPool;
+        p->setMaxThreadCount(default_io_threads);
+        return p;
+    }();
+    return *pool;
+}
+
+/**
+ * @brief 读取阶段读入内存的文件
+ */
+struct loaded_file {
+    QString path;
+    QByteArray data;
+    bool ok = false; /**< 是否成功读取 */
+};
+
+/**
+ * @brief 一次读入整个文件
+ */
+[[nodiscard]] inline loaded_file read_whole_file(const QString &path) {
+    stage_timer timer(batch_stage::read);
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {path};
+    }
+    loaded_file loaded{path, file.readAll(), true};
+    timer.set_bytes(loaded.data.size());
+    return loaded;
+}
+
+/**
+ * @brief 写出文件，先写临时文件再替换，其他程序不会读到写了一半的文件
+ */
+[[nodiscard]] inline bool write_file(const QString &path, const QByteArray &data) {
+    stage_timer timer(batch_stage::write);
+    timer.set_bytes(data.size());
+    QSaveFile file(path);
+    return file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+}
+
+/**
+ * @brief 计算阶段已经编码好、等待写入阶段写出的文件内容
+ */
+struct output_file {
+    QString path;
+    QByteArray data;
+};
+
+/**
+ * @brief 计算阶段的结果：处理结果与需要写出的文件
+ */
+template <typename Result>
+struct staged_result {
+    Result result;
+    std::vector<output_file> outputs;
+};
+
+/**
+ * @brief 流水线的各阶段
+ *
+ * 读取与写入在 io_pool 中执行，计算在全局线程池中执行。
+ */
+template <typename Input, typename Loaded, typename Result>
+struct pipeline_stages {
+    std::function<qint64(const Input &)> cost;                          /**< 预计的处理量（如文件大小），为空时按输入顺序处理 */
+    std::function<Loaded(const Input &)> load;                          /**< 读取；Loaded 与 Input 相同时可以为空，跳过读取阶段 */
+    std::function<staged_result<Result>(Loaded)> process;               /**< 计算（变换、编码、压缩） */
+    std::function<void(Result &, const output_file &)> write_failed;    /**< 写出文件失败时修改结果，可以为空 */
+    std::function<Result(const Input &, const std::exception &)> error; /**< 读取或计算抛出异常时的结果，为空时为 Result{} */
+};
+
+/**
+ * @brief 流水线的设置
+ */
+struct pipeline_settings {
+    int window = 0; /**< 已开始读取但还没有完成的任务数上限，0 表示计算线程数的 2 倍 */
+};
+
+namespace detail {
+
+template <typename Input, typename Loaded, typename Result>
+class pipeline_run : public std::enable_shared_from_this<pipeline_run<Input, Loaded, Result>> {
+public:
+    pipeline_run(QList<Input> inputs, pipeline_stages<Input, Loaded, Result> stages, pipeline_settings settings)
+        : inputs_(std::move(inputs)), stages_(std::move(stages)), window_(settings.window) {
+        if (window_ <= 0) {
+            window_ = 2 * std::max(QThreadPool::globalInstance()->maxThreadCount(), 1);
+        }
+    }
+
+    QFuture<Result> start() {
+        // 处理量大的任务先开始，避免最后只剩一个大文件在处理、其他线程空闲
+        order_.resize(inputs_.size());
+        std::iota(order_.begin(), order_.end(), 0);
+        if (stages_.cost) {
+            std::vector<qint64> costs(order_.size());
+            for (std::size_t i = 0; i < order_.size(); ++i) {
+                costs[i] = stages_.cost(inputs_[static_cast<int>(i)]);
+            }
+            std::ranges::stable_sort(order_, std::greater<>{}, [&](int index) { return costs[index]; });
+        }
+
+        future_.reportStarted();
+        future_.setProgressRange(0, inputs_.size());
+        const QFuture<Result> future = future_.future();
+
+        // 暂停时不再开始新任务，已开始的任务照常完成；继续或取消时由 watcher 在创建流水线的线程中重新检查。
+        // 暂停期间可能没有进行中的任务，由 watcher 持有本对象直到结束
+        auto *watcher = new QFutureWatcher<Result>;
+        const auto wake = [self = this->shared_from_this()] { self->pump(); };
+        QObject::connect(watcher, &QFutureWatcherBase::resumed, watcher, wake);
+        QObject::connect(watcher, &QFutureWatcherBase::canceled, watcher, wake);
+        QObject::connect(watcher, &QFutureWatcherBase::finished, watcher, &QObject::deleteLater);
+        watcher->setFuture(future);
+
+        if (inputs_.isEmpty()) {
+            future_.reportFinished();
+        } else {
+            pump();
+        }
+        return future;
+    }
+
+private:
+    // 在窗口允许的范围内开始新的任务；窗口限制了读入内存但还没有写出的数据量
+    void pump() {
+        std::vector<int> ready;
+        bool finished = false;
+        {
+            QMutexLocker locker(&mutex_);
+            while (next_ < order_.size() && active_ < window_ && !future_.isCanceled() && !future_.isPaused()) {
+                ready.push_back(order_[next_++]);
+                ++active_;
+            }
+            // 暂停期间取消时，进行中的任务可能已经全部完成
+            finished = drain_locked();
+        }
+        if (finished) {
+            future_.reportFinished();
+            return;
+        }
+        for (const int index : ready) {
+            if constexpr (std::is_same_v<Input, Loaded>) {
+                if (!stages_.load) {
+                    schedule_process(index, inputs_[index]);
+                    continue;
+                }
+            }
+            io_pool().start([self = this->shared_from_this(), index] { self->load(index); });
+        }
+    }
+
+    void load(int index) {
+        try {
+            schedule_process(index, stages_.load(inputs_[index]));
+        } catch (const std::exception &e) {
+            spdlog::error("流水线读取阶段失败: {}", e.what());
+            fail(index, e);
+        }
+    }
+
+    void schedule_process(int index, Loaded loaded) {
+        QThreadPool::globalInstance()->start(
+            [self = this->shared_from_this(), index, loaded = std::move(loaded)]() mutable {
+                self->process(index, std::move(loaded));
+            });
+    }
+
+    void process(int index, Loaded loaded) {
+        staged_result<Result> staged;
+        try {
+            staged = stages_.process(std::move(loaded));
+        } catch (const std::exception &e) {
+            spdlog::error("流水线计算阶段失败: {}", e.what());
+            fail(index, e);
+            return;
+        }
+        if (staged.outputs.empty()) {
+            complete(index, staged.result);
+            return;
+        }
+        io_pool().start([self = this->shared_from_this(), index, staged = std::move(staged)]() mutable {
+            self->write(index, staged);
+        });
+    }
+
+    void write(int index, staged_result<Result> &staged) {
+        for (const auto &output : staged.outputs) {
+            if (!write_file(output.path, output.data)) {
+                spdlog::error("写入失败: {}", output.path.toStdString());
+                if (stages_.write_failed) {
+                    stages_.write_failed(staged.result, output);
+                }
+            }
+        }
+        complete(index, staged.result);
+    }
+
+    // 读取或计算失败时同样报告一个结果，每个输入都恰好有一个结果，按下标等待结果的调用方不会阻塞
+    void fail(int index, const std::exception &e) {
+        const Result result = stages_.error ? stages_.error(inputs_[index], e) : Result{};
+        complete(index, result);
+    }
+
+    // 报告一个任务的结果，并继续开始新的任务
+    void complete(int index, const Result &result) {
+        future_.reportResult(result, index);
+        bool finished = false;
+        {
+            QMutexLocker locker(&mutex_);
+            --active_;
+            ++completed_;
+            future_.setProgressValue(completed_);
+            finished = drain_locked();
+        }
+        if (finished) {
+            future_.reportFinished();
+        } else {
+            pump();
+        }
+    }
+
+    // 全部完成，或取消后不再有进行中的任务时返回 true（只返回一次），由调用方报告结束
+    bool drain_locked() {
+        const bool drained = completed_ == inputs_.size() || (future_.isCanceled() && active_ == 0);
+        const bool finished = drained && !finished_;
+        finished_ = finished_ || drained;
+        return finished;
+    }
+
+    QList<Input> inputs_;
+    pipeline_stages<Input, Loaded, Result> stages_;
+    int window_;
+
+    QFutureInterface<Result> future_;
+    QMutex mutex_;
+    std::vector<int> order_; /**< 处理顺序：按预计处理量从大到小 */
+    std::size_t next_ = 0;   /**< order_ 中下一个开始的任务 */
+    int active_ = 0;         /**< 已开始还没有完成的任务数 */
+    int completed_ = 0;      /**< 已完成的任务数 */
+    bool finished_ = false;
+};
+
+} // namespace detail
+
+/**
+ * @brief 分阶段的批处理流水线：读取 → 计算 → 写入
+ *
+ * 读取与写入在 io_pool 中执行，计算在全局线程池中执行，等待 I/O 的线程不占用计算线程，计算繁忙时也不耽误读写。
+ * 同时在流水线中的任务数不超过 window，阶段之间排队的数据量有上限；任务按 cost 从大到小开始，减少批处理末尾的等待。
+ * 返回的 QFuture 与 QtConcurrent::mapped 的用法相同：每个输入恰好报告一个结果（读取或计算失败时为 error 的结果），
+ * 按输入的下标报告，进度为已完成的任务数；
+ * 暂停或取消后不再开始新任务，已开始的任务照常完成。
+ */
+template <typename Input, typename Loaded, typename Result>
+[[nodiscard]] QFuture<Result> run_pipeline(QList<Input> inputs,
+                                           pipeline_stages<Input, Loaded, Result> stages,
+                                           pipeline_settings settings = {}) {
+    auto run = std::make_shared<detail::pipeline_run<Input, Loaded, Result>>(
+        std::move(inputs), std::move(stages), settings);
+    return run->start();
+}
+
+} // namespace convert
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QByteArray>
+#include <QImage>
+#include <QIODevice>
+#include <QSaveFile>
+#include <QString>
+#include <QtEndian>
+#include <cstring>
+
+#include "chunk.h"
+
+namespace convert {
+
+namespace detail {
+
+// 写出一个 PNG 数据块：长度 + 类型 + 数据 + CRC（覆盖类型与数据）
+inline void append_png_chunk(QByteArray &png, const char (&type)[5], const char *data, int len) {
+    uchar length[4];
+    qToBigEndian<quint32>(static_cast<quint32>(len), length);
+    png.append(reinterpret_cast<const char *>(length), 4);
+
+    const int start = png.size();
+    png.append(type, 4);
+    png.append(data, len);
+
+    uchar crc[4];
+    qToBigEndian<quint32>(crc32(png.constData() + start, static_cast<std::size_t>(len) + 4), crc);
+    png.append(reinterpret_cast<const char *>(crc), 4);
+}
+
+} // namespace detail
+
+/**
+ * @brief 将 1 位图像编码为 1 位调色板 PNG
+ * @param img Format_Mono 图像（其他格式返回空）
+ * @param level zlib 压缩级别（0~9），-1 为 zlib 默认级别
+ * @return PNG 文件内容
+ *
+ * @details 扫描行原样作为 PNG 的 1 位索引数据（两者都是 MSB 在前），每行使用 None 过滤，
+ *          只需一次 deflate，不经过 8 位格式转换与逐行自适应过滤。图片的 DPI 写入 pHYs 块。
+ */
+[[nodiscard]] inline QByteArray encode_mono_png(const QImage &img, int level = 6) {
+    if (img.format() != QImage::Format_Mono || img.isNull()) {
+        return {};
+    }
+
+    const int width = img.width();
+    const int height = img.height();
+    const int rowBytes = (width + 7) / 8;
+
+    QByteArray raw((rowBytes + 1) * height, Qt::Uninitialized);
+    char *dst = raw.data();
+    for (int y = 0; y < height; ++y) {
+        *dst++ = 0; // 过滤类型 None
+        std::memcpy(dst, img.constScanLine(y), static_cast<std::size_t>(rowBytes));
+        dst += rowBytes;
+    }
+    // qCompress 输出 = 4 字节原始长度 + zlib 数据流，PNG 的 IDAT 只需要后者
+    const QByteArray compressed = qCompress(raw, level);
+
+    QByteArray png;
+    png.reserve(compressed.size() + 128);
+    png.append("\x89PNG\r\n\x1a\n", 8);
+
+    uchar ihdr[13];
+    qToBigEndian<quint32>(static_cast<quint32>(width), ihdr);
+    qToBigEndian<quint32>(static_cast<quint32>(height), ihdr + 4);
+    ihdr[8] = 1;  // 位深
+    ihdr[9] = 3;  // 颜色类型：调色板
+    ihdr[10] = 0; // 压缩方法
+    ihdr[11] = 0; // 过滤方法
+    ihdr[12] = 0; // 不隔行
+    detail::append_png_chunk(png, "IHDR", reinterpret_cast<const char *>(ihdr), sizeof(ihdr));
+
+    char plte[6];
+    for (int i = 0; i < 2; ++i) {
+        const QRgb color = img.color(i);
+        plte[i * 3] = static_cast<char>(qRed(color));
+        plte[i * 3 + 1] = static_cast<char>(qGreen(color));
+        plte[i * 3 + 2] = static_cast<char>(qBlue(color));
+    }
+    detail::append_png_chunk(png, "PLTE", plte, sizeof(plte));
+
+    if (img.dotsPerMeterX() > 0 && img.dotsPerMeterY() > 0) {
+        uchar phys[9];
+        qToBigEndian<quint32>(static_cast<quint32>(img.dotsPerMeterX()), phys);
+        qToBigEndian<quint32>(static_cast<quint32>(img.dotsPerMeterY()), phys + 4);
+        phys[8] = 1; // 单位：米
+        detail::append_png_chunk(png, "pHYs", reinterpret_cast<const char *>(phys), sizeof(phys));
+    }
+
+    detail::append_png_chunk(png, "IDAT", compressed.constData() + 4, compressed.size() - 4);
+    detail::append_png_chunk(png, "IEND", nullptr, 0);
+    return png;
+}
+
+/**
+ * @brief 以 PNG 写入设备：1 位图像使用 encode_mono_png，其他格式交给 QImage::save
+ * @param level zlib 压缩级别（0~9）
+ */
+[[nodiscard]] inline bool write_png(const QImage &img, QIODevice &device, int level = 6) {
+    if (img.format() != QImage::Format_Mono) {
+        return img.save(&device, "PNG");
+    }
+    const QByteArray png = encode_mono_png(img, level);
+    return !png.isEmpty() && device.write(png) == png.size();
+}
+
+/**
+ * @brief 保存条码图片，PNG 经 write_png 写入临时文件后再替换目标文件，其他格式交给 QImage::save
+ * @param level PNG 的 zlib 压缩级别（0~9）
+ */
+[[nodiscard]] inline bool save_image(const QImage &img, const QString &path, int level = 6) {
+    if (!path.endsWith(".png", Qt::CaseInsensitive)) {
+        return img.save(path);
+    }
+
+    QSaveFile file(path);
+    return file.open(QIODevice::WriteOnly) && write_png(img, file, level) && file.commit();
+}
+
+} // namespace convert
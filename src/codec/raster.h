@@ -0,0 +1,123 @@
+#pragma once
+
+#include <QImage>
+#include <QVector>
+#include <ZXing/BitMatrix.h>
+#include <algorithm>
+#include <cstring>
+
+#include "timing.h"
+
+namespace convert {
+
+/**
+ * @brief 将 1 位图像一行中 [from, to) 范围内的像素置为 0（黑色），MSB 在前
+ */
+inline void clear_mono_bits(uchar *line, int from, int to) noexcept {
+    if (from >= to) {
+        return;
+    }
+    const int first = from >> 3;
+    const int last = (to - 1) >> 3;
+    const uchar head = static_cast<uchar>(0xFF >> (from & 7));            // first 字节中需要清除的位
+    const uchar tail = static_cast<uchar>(0xFF << (7 - ((to - 1) & 7))); // last 字节中需要清除的位
+    if (first == last) {
+        line[first] &= static_cast<uchar>(~(head & tail));
+        return;
+    }
+    line[first] &= static_cast<uchar>(~head);
+    std::memset(line + first + 1, 0x00, static_cast<std::size_t>(last - first - 1));
+    line[last] &= static_cast<uchar>(~tail);
+}
+
+/**
+ * @brief 将模块级（每模块1像素）的 BitMatrix 直接光栅化为目标尺寸的图像
+ * @param modules 条码模块矩阵（含静区），通常由 MultiFormatWriter::encode(text, 0, 0) 得到
+ * @param target_width 目标宽度（像素）
+ * @param target_height 目标高度（像素）
+ * @return 目标尺寸的 1 位图像（Format_Mono，索引 0 为黑、1 为白），矩阵为空时返回空图片
+ *
+ * @details 条码只有黑白两色，按 1 位存储，内存只有 8 位灰度图的 1/8，并可直接写为 1 位 PNG（见 write_mono_png）。
+ *          每个模块按整数倍复制为 s×s 的像素块，条码居中、剩余部分留白，模块边缘保持锐利。
+ *          每一行按连续的黑色模块整段清零，同一模块行内的其余像素行直接 memcpy 复制，
+ *          整幅图像只写一遍。一维码（矩阵只有一行）横向整数倍复制，纵向铺满目标高度。
+ *          只有模块网格大于目标尺寸（放不下一个像素一个模块）时才退回到重采样并二值化。
+ */
+[[nodiscard]] inline QImage rasterize_bitmatrix(const ZXing::BitMatrix &modules, int target_width, int target_height) {
+    const int moduleCols = modules.width();
+    const int moduleRows = modules.height();
+    if (moduleCols <= 0 || moduleRows <= 0 || target_width <= 0 || target_height <= 0) {
+        return {};
+    }
+    const stage_timer timer(batch_stage::rasterize);
+
+    const QVector<QRgb> colorTable{qRgb(0, 0, 0), qRgb(255, 255, 255)};
+
+    const bool linear = moduleRows == 1;
+    const int scale = linear ? target_width / moduleCols
+                             : std::min(target_width / moduleCols, target_height / moduleRows);
+
+    if (scale < 1) {
+        // 目标尺寸小于模块网格，无法整数复制，先按每模块1像素绘制，缩放后再二值化
+        QImage native(moduleCols, moduleRows, QImage::Format_Grayscale8);
+        for (int y = 0; y < moduleRows; ++y) {
+            uchar *line = native.scanLine(y);
+            for (int x = 0; x < moduleCols; ++x) {
+                line[x] = modules.get(x, y) ? 0x00 : 0xFF;
+            }
+        }
+        return native.scaled(target_width, target_height, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+            .convertToFormat(QImage::Format_Mono, colorTable, Qt::ThresholdDither);
+    }
+
+    const int moduleHeight = linear ? target_height : scale;
+    const int left = (target_width - moduleCols * scale) / 2;
+    const int top = linear ? 0 : (target_height - moduleRows * moduleHeight) / 2;
+
+    QImage image(target_width, target_height, QImage::Format_Mono);
+    image.setColorTable(colorTable);
+    image.fill(1);
+
+    const auto bytesPerLine = static_cast<std::size_t>(image.bytesPerLine());
+    for (int my = 0; my < moduleRows; ++my) {
+        const int y0 = top + my * moduleHeight;
+        uchar *first = image.scanLine(y0);
+
+        for (int mx = 0; mx < moduleCols;) {
+            if (!modules.get(mx, my)) {
+                ++mx;
+                continue;
+            }
+            const int runStart = mx;
+            while (mx < moduleCols && modules.get(mx, my)) {
+                ++mx;
+            }
+            clear_mono_bits(first, left + runStart * scale, left + mx * scale);
+        }
+
+        for (int dy = 1; dy < moduleHeight; ++dy) {
+            std::memcpy(image.scanLine(y0 + dy), first, bytesPerLine);
+        }
+    }
+
+    return image;
+}
+
+/**
+ * @brief rasterize_bitmatrix 的逆过程：从每模块 1 像素的图像恢复模块矩阵
+ */
+[[nodiscard]] inline ZXing::BitMatrix modules_from_image(const QImage &image) {
+    const QImage gray = image.convertToFormat(QImage::Format_Grayscale8);
+    ZXing::BitMatrix modules(gray.width(), gray.height());
+    for (int y = 0; y < gray.height(); ++y) {
+        const uchar *line = gray.constScanLine(y);
+        for (int x = 0; x < gray.width(); ++x) {
+            if (line[x] < 0x80) {
+                modules.set(x, y);
+            }
+        }
+    }
+    return modules;
+}
+
+} // namespace convert
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QImage>
+#include <ZXing/BitMatrix.h>
+#include <memory>
+
+namespace convert {
+
+/**
+ * @brief 矢量输出（SVG/PDF）所需的条码模块矩阵与目标尺寸
+ */
+struct vector_symbol {
+    ZXing::BitMatrix modules; /**< 每模块一位的矩阵（含静区） */
+    int width = 0;            /**< 目标宽度（像素） */
+    int height = 0;           /**< 目标高度（像素） */
+    int ppi = 300;            /**< 像素密度，用于换算物理尺寸 */
+};
+
+/**
+ * @brief 一个生成好的条码：用于显示与 PNG 输出的 1 位图像，以及用于矢量输出的模块矩阵
+ */
+struct barcode_symbol {
+    QImage image;                                /**< 目标尺寸的 1 位图像，只需矢量输出时可以为空 */
+    std::shared_ptr<const vector_symbol> vector; /**< 模块矩阵，生成失败时为空 */
+
+    explicit operator bool() const noexcept {
+        return vector != nullptr || !image.isNull();
+    }
+};
+
+} // namespace convert
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <QRect>
+#include <QSize>
+#include <algorithm>
+#include <vector>
+
+namespace convert {
+
+/**
+ * @brief 分块识别的默认块大小（像素），长边超过块大小 1.5 倍的图像才分块
+ */
+inline constexpr int default_decode_tile_size = 2048;
+
+namespace detail {
+
+// 一个方向上各块的起点：相邻块重叠 overlap 像素，最后一块与图像边缘对齐
+[[nodiscard]] inline std::vector<int> tile_starts(int length, int tile, int overlap) {
+    if (length <= tile) {
+        return {0};
+    }
+    const int step = std::max(1, tile - overlap);
+    std::vector<int> starts;
+    for (int start = 0; start + tile < length; start += step) {
+        starts.push_back(start);
+    }
+    starts.push_back(length - tile);
+    return starts;
+}
+
+} // namespace detail
+
+/**
+ * @brief 是否需要分块识别
+ * @param tile_size 块大小，0 表示不分块
+ */
+[[nodiscard]] inline bool should_tile(const QSize &size, int tile_size) noexcept {
+    return tile_size > 0 && std::max(size.width(), size.height()) > tile_size + tile_size / 2;
+}
+
+/**
+ * @brief 将图像切分为相互重叠的块
+ * @param tile_size 块的边长
+ * @param overlap 相邻块的重叠宽度，不超过该宽度的条码至少完整地落在一个块中
+ */
+[[nodiscard]] inline std::vector<QRect> split_tiles(const QSize &size, int tile_size, int overlap) {
+    std::vector<QRect> tiles;
+    const auto xs = detail::tile_starts(size.width(), tile_size, overlap);
+    const auto ys = detail::tile_starts(size.height(), tile_size, overlap);
+    tiles.reserve(xs.size() * ys.size());
+    for (const int y : ys) {
+        for (const int x : xs) {
+            tiles.emplace_back(x, y, std::min(tile_size, size.width()), std::min(tile_size, size.height()));
+        }
+    }
+    return tiles;
+}
+
+} // namespace convert
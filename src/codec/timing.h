@@ -0,0 +1,323 @@
+#pragma once
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringList>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <spdlog/spdlog.h>
+#include <vector>
+
+namespace convert {
+
+/**
+ * @brief 批处理中分别计时的阶段
+ */
+enum class batch_stage {
+    read,         /**< 读取输入文件 */
+    base64,       /**< Base64 编码或解码 */
+    compress,     /**< zlib 压缩或解压 */
+    encode,       /**< zxing 生成模块矩阵（MultiFormatWriter::encode） */
+    rasterize,    /**< 模块矩阵光栅化为目标尺寸 */
+    resize,       /**< 图片缩放（缩略图、精确尺寸） */
+    image_decode, /**< 图片解码为灰度图（cv::imdecode、cv::imreadmulti） */
+    barcode_read, /**< zxing 识别条码（ReadBarcodes 级联，含分块识别） */
+    image_encode, /**< 结果编码为 PNG/SVG/PDF */
+    write,        /**< 写出文件 */
+};
+
+inline constexpr std::size_t batch_stage_count = static_cast<std::size_t>(batch_stage::write) + 1;
+
+/**
+ * @brief 耗时汇总写在输出目录中的文件名，见 batch_timing::to_json
+ */
+inline constexpr auto timing_file_name = "lab2qrcode_timing.json";
+
+[[nodiscard]] constexpr const char *batch_stage_name(batch_stage stage) noexcept {
+    switch (stage) {
+    case batch_stage::read: return "read";
+    case batch_stage::base64: return "base64";
+    case batch_stage::compress: return "compress";
+    case batch_stage::encode: return "encode";
+    case batch_stage::rasterize: return "rasterize";
+    case batch_stage::resize: return "resize";
+    case batch_stage::image_decode: return "image_decode";
+    case batch_stage::barcode_read: return "barcode_read";
+    case batch_stage::image_encode: return "image_encode";
+    case batch_stage::write: return "write";
+    default: return "unknown";
+    }
+}
+
+/**
+ * @brief 一个阶段在一批中的耗时统计
+ */
+struct stage_summary {
+    batch_stage stage = batch_stage::read;
+    std::size_t count = 0; /**< 计时次数（分块、多页与多个条码各计一次） */
+    double total_ms = 0;   /**< 各次耗时之和，多线程并行时可能大于批处理的实际耗时 */
+    double p50_ms = 0;
+    double p90_ms = 0;
+    double p99_ms = 0;
+    double max_ms = 0;
+    qint64 bytes = 0; /**< 读取与写入阶段处理的字节数 */
+};
+
+/**
+ * @brief 一批的耗时汇总：各阶段的分位数与整批的吞吐量
+ */
+struct batch_timing {
+    int files = 0;                     /**< 完成的任务数 */
+    qint64 bytes = 0;                  /**< 读入的字节数，没有读取阶段（如保存）时为写出的字节数 */
+    double seconds = 0;                /**< 批处理的实际耗时 */
+    std::vector<stage_summary> stages; /**< 有记录的阶段，按 batch_stage 的顺序 */
+
+    [[nodiscard]] double files_per_second() const noexcept {
+        return seconds > 0 ? files / seconds : 0;
+    }
+
+    [[nodiscard]] double mb_per_second() const noexcept {
+        return seconds > 0 ? bytes / 1048576.0 / seconds : 0;
+    }
+
+    /**
+     * @brief 一行的概要：任务数、耗时与吞吐量
+     */
+    [[nodiscard]] QString summary_line() const {
+        return QCoreApplication::translate("convert", "%1 个文件，耗时 %2 s，%3 个/s，%4 MB/s")
+            .arg(files)
+            .arg(seconds, 0, 'f', 2)
+            .arg(files_per_second(), 0, 'f', 1)
+            .arg(mb_per_second(), 0, 'f', 2);
+    }
+
+    /**
+     * @brief 概要与各阶段的耗时，每个阶段一行
+     */
+    [[nodiscard]] QString report() const {
+        QStringList lines{summary_line()};
+        for (const auto &s : stages) {
+            lines.append(QString("%1: n=%2, p50 %3 ms, p90 %4 ms, p99 %5 ms, max %6 ms, total %7 ms")
+                             .arg(batch_stage_name(s.stage))
+                             .arg(s.count)
+                             .arg(s.p50_ms, 0, 'f', 2)
+                             .arg(s.p90_ms, 0, 'f', 2)
+                             .arg(s.p99_ms, 0, 'f', 2)
+                             .arg(s.max_ms, 0, 'f', 2)
+                             .arg(s.total_ms, 0, 'f', 1));
+        }
+        return lines.join('\n');
+    }
+
+    [[nodiscard]] QByteArray to_json() const {
+        QJsonObject stage_objects;
+        for (const auto &s : stages) {
+            QJsonObject stage;
+            stage.insert("count", static_cast<qint64>(s.count));
+            stage.insert("total_ms", s.total_ms);
+            stage.insert("p50_ms", s.p50_ms);
+            stage.insert("p90_ms", s.p90_ms);
+            stage.insert("p99_ms", s.p99_ms);
+            stage.insert("max_ms", s.max_ms);
+            stage.insert("bytes", s.bytes);
+            stage_objects.insert(batch_stage_name(s.stage), stage);
+        }
+        QJsonObject root;
+        root.insert("files", files);
+        root.insert("bytes", bytes);
+        root.insert("seconds", seconds);
+        root.insert("files_per_second", files_per_second());
+        root.insert("mb_per_second", mb_per_second());
+        root.insert("stages", stage_objects);
+        return QJsonDocument(root).toJson();
+    }
+
+    void log(const char *kind) const {
+        spdlog::info("{}耗时: {}", kind, summary_line().toStdString());
+        for (const auto &s : stages) {
+            spdlog::info("  {:<12} n={:<6} p50 {:>9.2f} ms  p90 {:>9.2f} ms  p99 {:>9.2f} ms  max {:>9.2f} ms",
+                         batch_stage_name(s.stage),
+                         s.count,
+                         s.p50_ms,
+                         s.p90_ms,
+                         s.p99_ms,
+                         s.max_ms);
+        }
+    }
+};
+
+/**
+ * @brief 批处理各阶段的耗时记录（进程内单例，线程安全）
+ *
+ * begin 与 finish 之间，各阶段的 stage_timer 把每次的耗时记录下来；不在批处理中时计时器不读时钟也不加锁。
+ * 同一时间只统计一批：界面中批处理互斥，命令行一次运行一批。
+ */
+class stage_timings {
+public:
+    [[nodiscard]] static stage_timings &instance() {
+        static stage_timings timings;
+        return timings;
+    }
+
+    /**
+     * @brief 清空记录，开始统计新的一批
+     */
+    void begin() {
+        QMutexLocker locker(&mutex_);
+        for (auto &samples : samples_) {
+            samples.clear();
+        }
+        bytes_.fill(0);
+        clock_.start();
+        active_.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief 停止统计并汇总
+     * @param files 完成的任务数
+     */
+    [[nodiscard]] batch_timing finish(int files) {
+        active_.store(false, std::memory_order_relaxed);
+        QMutexLocker locker(&mutex_);
+        batch_timing timing;
+        timing.files = files;
+        timing.seconds = clock_.isValid() ? clock_.nsecsElapsed() / 1e9 : 0;
+        const auto read = bytes_[static_cast<std::size_t>(batch_stage::read)];
+        timing.bytes = read > 0 ? read : bytes_[static_cast<std::size_t>(batch_stage::write)];
+
+        for (std::size_t i = 0; i < batch_stage_count; ++i) {
+            auto &samples = samples_[i];
+            if (samples.empty()) {
+                continue;
+            }
+            std::ranges::sort(samples);
+            // 最近秩法：不小于 p 比例样本的最小值
+            const auto percentile = [&](double p) {
+                const auto rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(samples.size())));
+                return samples[std::clamp<std::size_t>(rank, 1, samples.size()) - 1] / 1e6;
+            };
+            stage_summary s;
+            s.stage = static_cast<batch_stage>(i);
+            s.count = samples.size();
+            for (const auto ns : samples) {
+                s.total_ms += ns / 1e6;
+            }
+            s.p50_ms = percentile(0.50);
+            s.p90_ms = percentile(0.90);
+            s.p99_ms = percentile(0.99);
+            s.max_ms = samples.back() / 1e6;
+            s.bytes = bytes_[i];
+            timing.stages.push_back(s);
+        }
+        return timing;
+    }
+
+    [[nodiscard]] bool active() const noexcept {
+        return active_.load(std::memory_order_relaxed);
+    }
+
+    void record(batch_stage stage, qint64 nsecs, qint64 bytes = 0) {
+        const auto i = static_cast<std::size_t>(stage);
+        QMutexLocker locker(&mutex_);
+        if (!active()) {
+            return;
+        }
+        samples_[i].push_back(nsecs);
+        bytes_[i] += bytes;
+    }
+
+private:
+    stage_timings() = default;
+
+    mutable QMutex mutex_;
+    std::atomic<bool> active_{false};
+    QElapsedTimer clock_; /**< 本批开始的时间 */
+    std::array<std::vector<qint64>, batch_stage_count> samples_;
+    std::array<qint64, batch_stage_count> bytes_{};
+};
+
+/**
+ * @brief 作用域计时器：析构时把经过的时间记入 stage_timings 的对应阶段
+ */
+class stage_timer {
+public:
+    explicit stage_timer(batch_stage stage) noexcept
+        : stage_(stage) {
+        if (stage_timings::instance().active()) {
+            clock_.start();
+        }
+    }
+
+    ~stage_timer() {
+        if (clock_.isValid()) {
+            stage_timings::instance().record(stage_, clock_.nsecsElapsed(), bytes_);
+        }
+    }
+
+    stage_timer(const stage_timer &) = delete;
+    stage_timer &operator=(const stage_timer &) = delete;
+
+    /**
+     * @brief 记录本次处理的字节数（读取与写入阶段）
+     */
+    void set_bytes(qint64 bytes) noexcept {
+        bytes_ = bytes;
+    }
+
+private:
+    batch_stage stage_;
+    qint64 bytes_ = 0;
+    QElapsedTimer clock_; /**< 不在批处理中时不启动 */
+};
+
+/**
+ * @brief 分段累计一个阶段的耗时，析构时作为一次记录，用于读取与编码交替进行的循环
+ */
+class stage_accumulator {
+public:
+    explicit stage_accumulator(batch_stage stage) noexcept
+        : stage_(stage), active_(stage_timings::instance().active()) {}
+
+    ~stage_accumulator() {
+        if (active_) {
+            stage_timings::instance().record(stage_, nsecs_, bytes_);
+        }
+    }
+
+    stage_accumulator(const stage_accumulator &) = delete;
+    stage_accumulator &operator=(const stage_accumulator &) = delete;
+
+    void start() noexcept {
+        if (active_) {
+            clock_.start();
+        }
+    }
+
+    void stop() noexcept {
+        if (active_) {
+            nsecs_ += clock_.nsecsElapsed();
+        }
+    }
+
+    void add_bytes(qint64 bytes) noexcept {
+        bytes_ += bytes;
+    }
+
+private:
+    batch_stage stage_;
+    bool active_;
+    qint64 nsecs_ = 0;
+    qint64 bytes_ = 0;
+    QElapsedTimer clock_;
+};
+
+} // namespace convert
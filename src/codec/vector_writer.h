@@ -0,0 +1,260 @@
+#pragma once
+
+#include <QBuffer>
+#include <QByteArray>
+#include <QFileInfo>
+#include <QImage>
+#include <QSaveFile>
+#include <QString>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "png_writer.h"
+#include "symbol.h"
+#include "timing.h"
+
+namespace convert {
+
+namespace detail {
+
+/**
+ * @brief 模块矩阵一行中连续的黑色模块
+ */
+struct module_run {
+    int x = 0;   /**< 起始列 */
+    int y = 0;   /**< 所在行 */
+    int len = 0; /**< 连续的模块数 */
+};
+
+// 按行合并连续的黑色模块，输出的图形数量与条码边缘数量相当，而不是与模块数量相当
+[[nodiscard]] inline std::vector<module_run> module_runs(const ZXing::BitMatrix &modules) {
+    std::vector<module_run> runs;
+    for (int y = 0; y < modules.height(); ++y) {
+        for (int x = 0; x < modules.width();) {
+            if (!modules.get(x, y)) {
+                ++x;
+                continue;
+            }
+            const int start = x;
+            while (x < modules.width() && modules.get(x, y)) {
+                ++x;
+            }
+            runs.push_back({start, y, x - start});
+        }
+    }
+    return runs;
+}
+
+/**
+ * @brief 模块在目标尺寸内的摆放，见 layout_modules
+ */
+struct module_layout {
+    double left = 0;
+    double top = 0;
+    double scale_x = 0;
+    double scale_y = 0;
+};
+
+/**
+ * @brief 按 rasterize_bitmatrix 的规则摆放模块，矢量输出与同参数的 PNG 像素对齐
+ * @param unit 每像素对应的输出单位（SVG 为 1 像素，PDF 为 72/ppi 点）
+ *
+ * @details 每个模块为整数 s×s 像素，条码居中、剩余部分留白（偏移向下取整）；一维码横向整数倍、纵向铺满目标高度。
+ *          模块网格大于目标尺寸时与位图一样拉伸铺满整个目标尺寸。
+ */
+[[nodiscard]] inline module_layout layout_modules(const vector_symbol &symbol, double unit = 1) {
+    const int cols = symbol.modules.width();
+    const int rows = symbol.modules.height();
+    const bool linear = rows == 1;
+    const int scale = linear ? symbol.width / cols : std::min(symbol.width / cols, symbol.height / rows);
+    if (scale < 1) {
+        return {0, 0, unit * symbol.width / cols, unit * symbol.height / rows};
+    }
+    const int moduleHeight = linear ? symbol.height : scale;
+    const int left = (symbol.width - cols * scale) / 2;
+    const int top = linear ? 0 : (symbol.height - rows * moduleHeight) / 2;
+    return {unit * left, unit * top, unit * scale, unit * moduleHeight};
+}
+
+// 保留 4 位小数并去掉末尾的 0，坐标文本尽量短
+[[nodiscard]] inline QByteArray number(double value) {
+    QByteArray text = QByteArray::number(value, 'f', 4);
+    while (text.endsWith('0')) {
+        text.chop(1);
+    }
+    if (text.endsWith('.')) {
+        text.chop(1);
+    }
+    return text == "-0" ? QByteArray("0") : text;
+}
+
+} // namespace detail
+
+/**
+ * @brief 由模块矩阵生成 SVG
+ * @return SVG 文件内容，矩阵为空时返回空
+ *
+ * @details 坐标以像素为单位（viewBox 与位图尺寸一致），width/height 按 ppi 换算为毫米，打印尺寸与 PNG 相同。
+ *          每行连续的黑色模块合并为一个矩形子路径，整个条码只有一个 path 元素。
+ */
+[[nodiscard]] inline QByteArray encode_svg(const vector_symbol &symbol) {
+    if (symbol.modules.width() <= 0 || symbol.width <= 0 || symbol.height <= 0 || symbol.ppi <= 0) {
+        return {};
+    }
+    using detail::number;
+    const auto layout = detail::layout_modules(symbol);
+    const double mm = 25.4 / symbol.ppi;
+
+    QByteArray svg;
+    svg.append(R"(<?xml version="1.0" encoding="UTF-8"?>)" "\n");
+    svg.append(R"(<svg xmlns="http://www.w3.org/2000/svg" version="1.1" width=")")
+        .append(number(symbol.width * mm))
+        .append(R"(mm" height=")")
+        .append(number(symbol.height * mm))
+        .append(R"(mm" viewBox="0 0 )")
+        .append(QByteArray::number(symbol.width))
+        .append(' ')
+        .append(QByteArray::number(symbol.height))
+        .append(R"(" shape-rendering="crispEdges">)" "\n");
+    svg.append(R"(<rect width="100%" height="100%" fill="#fff"/>)" "\n");
+    svg.append(R"(<g transform="translate()")
+        .append(number(layout.left))
+        .append(' ')
+        .append(number(layout.top))
+        .append(") scale(")
+        .append(number(layout.scale_x))
+        .append(' ')
+        .append(number(layout.scale_y))
+        .append(R"()"><path fill="#000" d=")");
+    for (const auto &run : detail::module_runs(symbol.modules)) {
+        svg.append('M')
+            .append(QByteArray::number(run.x))
+            .append(' ')
+            .append(QByteArray::number(run.y))
+            .append('h')
+            .append(QByteArray::number(run.len))
+            .append("v1h-")
+            .append(QByteArray::number(run.len))
+            .append('z');
+    }
+    svg.append("\"/></g>\n</svg>\n");
+    return svg;
+}
+
+/**
+ * @brief 由模块矩阵生成单页 PDF
+ * @param level 内容流的 zlib 压缩级别（0~9）
+ * @return PDF 文件内容，矩阵为空时返回空
+ *
+ * @details 页面尺寸按 ppi 换算为点（1/72 英寸），与 PNG 的打印尺寸相同。内容流以一个变换矩阵把模块坐标映射到页面，
+ *          每行连续的黑色模块输出一个 re 矩形，最后一次填充；内容流以 FlateDecode 压缩。
+ */
+[[nodiscard]] inline QByteArray encode_pdf(const vector_symbol &symbol, int level = 6) {
+    if (symbol.modules.width() <= 0 || symbol.width <= 0 || symbol.height <= 0 || symbol.ppi <= 0) {
+        return {};
+    }
+    using detail::number;
+    const double pageWidth = symbol.width * 72.0 / symbol.ppi;
+    const double pageHeight = symbol.height * 72.0 / symbol.ppi;
+    const auto layout = detail::layout_modules(symbol, 72.0 / symbol.ppi);
+
+    // PDF 的 y 轴向上，矩阵第 0 行在页面顶部
+    QByteArray content;
+    content.append("1 1 1 rg 0 0 ")
+        .append(number(pageWidth))
+        .append(' ')
+        .append(number(pageHeight))
+        .append(" re f\n0 0 0 rg\n")
+        .append(number(layout.scale_x))
+        .append(" 0 0 ")
+        .append(number(-layout.scale_y))
+        .append(' ')
+        .append(number(layout.left))
+        .append(' ')
+        .append(number(pageHeight - layout.top))
+        .append(" cm\n");
+    for (const auto &run : detail::module_runs(symbol.modules)) {
+        content.append(QByteArray::number(run.x))
+            .append(' ')
+            .append(QByteArray::number(run.y))
+            .append(' ')
+            .append(QByteArray::number(run.len))
+            .append(" 1 re\n");
+    }
+    content.append("f\n");
+    // qCompress 输出 = 4 字节原始长度 + zlib 数据流，FlateDecode 只需要后者
+    const QByteArray stream = qCompress(content, level).mid(4);
+
+    QByteArray pdf("%PDF-1.4\n%\xE2\xE3\xCF\xD3\n");
+    std::vector<int> offsets;
+    const auto object = [&](const QByteArray &body) {
+        offsets.push_back(pdf.size());
+        pdf.append(QByteArray::number(static_cast<int>(offsets.size())))
+            .append(" 0 obj\n")
+            .append(body)
+            .append("\nendobj\n");
+    };
+    object("<< /Type /Catalog /Pages 2 0 R >>");
+    object("<< /Type /Pages /Kids [3 0 R] /Count 1 >>");
+    object("<< /Type /Page /Parent 2 0 R /MediaBox [0 0 " + number(pageWidth) + ' ' + number(pageHeight) +
+           "] /Contents 4 0 R /Resources << >> >>");
+    object("<< /Length " + QByteArray::number(stream.size()) + " /Filter /FlateDecode >>\nstream\n" + stream +
+           "\nendstream");
+
+    const int xref = pdf.size();
+    pdf.append("xref\n0 ").append(QByteArray::number(static_cast<int>(offsets.size()) + 1)).append('\n');
+    pdf.append("0000000000 65535 f \n");
+    for (const int offset : offsets) {
+        pdf.append(QByteArray::number(offset).rightJustified(10, '0')).append(" 00000 n \n");
+    }
+    pdf.append("trailer\n<< /Size ")
+        .append(QByteArray::number(static_cast<int>(offsets.size()) + 1))
+        .append(" /Root 1 0 R >>\nstartxref\n")
+        .append(QByteArray::number(xref))
+        .append("\n%%EOF\n");
+    return pdf;
+}
+
+/**
+ * @brief 按扩展名把条码编码为文件内容，不写盘：.svg/.pdf 由模块矩阵生成，.png 经 write_png 压缩，其他格式交给 QImage::save
+ * @param path 目标文件名，只用于确定格式
+ * @return 编码失败或缺少所需的图片/模块矩阵时返回空
+ */
+[[nodiscard]] inline QByteArray encode_symbol(const QImage &img,
+                                              const std::shared_ptr<const vector_symbol> &vector,
+                                              const QString &path,
+                                              int level = 6) {
+    const stage_timer timer(batch_stage::image_encode);
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (suffix == "svg" || suffix == "pdf") {
+        return !vector ? QByteArray{} : suffix == "svg" ? encode_svg(*vector) : encode_pdf(*vector, level);
+    }
+    if (img.isNull()) {
+        return {};
+    }
+
+    QByteArray data;
+    QBuffer buffer(&data);
+    buffer.open(QIODevice::WriteOnly);
+    const bool ok = suffix == "png" || suffix.isEmpty() ? write_png(img, buffer, level)
+                                                        : img.save(&buffer, suffix.toLatin1().constData());
+    return ok ? data : QByteArray{};
+}
+
+/**
+ * @brief 按扩展名保存条码（见 encode_symbol），先写临时文件再替换目标文件
+ * @param img 条码图片，只需矢量输出时可以为空
+ * @param vector 条码的模块矩阵，保存为位图时可以为空
+ * @param level PNG 与 PDF 内容流的 zlib 压缩级别（0~9）
+ */
+[[nodiscard]] inline bool save_symbol(const QImage &img,
+                                      const std::shared_ptr<const vector_symbol> &vector,
+                                      const QString &path,
+                                      int level = 6) {
+    const QByteArray data = encode_symbol(img, vector, path, level);
+    QSaveFile file(path);
+    return !data.isEmpty() && file.open(QIODevice::WriteOnly) && file.write(data) == data.size() && file.commit();
+}
+
+} // namespace convert
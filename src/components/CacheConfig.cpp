@@ -0,0 +1,52 @@
+#include "CacheConfig.h"
+#include "../logging.h"
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+CacheConfig CacheConfig::loadFromConfig(const std::string &filename) {
+    CacheConfig config;
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            spdlog::warn("Config file not found, using default cache config: {}", filename);
+            return config;
+        }
+
+        json configJson;
+        file >> configJson;
+
+        if (configJson.contains("cache")) {
+            const auto &cache = configJson["cache"];
+
+            if (cache.contains("memory_mb") && cache["memory_mb"].get<int>() >= 0) {
+                config.memory_mb = cache["memory_mb"].get<std::size_t>();
+            }
+
+            if (cache.contains("spill_dir")) {
+                config.spill_dir = cache["spill_dir"].get<std::string>();
+            }
+
+            if (cache.contains("decode_cache")) {
+                config.decode_cache = cache["decode_cache"].get<bool>();
+            }
+
+            if (cache.contains("decode_cache_mb") && cache["decode_cache_mb"].get<int>() > 0) {
+                config.decode_cache_mb = cache["decode_cache_mb"].get<std::size_t>();
+            }
+
+            spdlog::info("Loaded cache config: memory_mb={}, spill_dir={}, decode_cache={}, decode_cache_mb={}",
+                         config.memory_mb,
+                         config.spill_dir,
+                         config.decode_cache,
+                         config.decode_cache_mb);
+        } else {
+            spdlog::info("No cache section in config, using defaults");
+        }
+    } catch (const std::exception &e) { spdlog::error("Failed to load cache config: {}", e.what()); }
+
+    return config;
+}
@@ -0,0 +1,24 @@
+#ifndef CACHECONFIG_H
+#define CACHECONFIG_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 生成图片缓存与解码结果缓存配置结构体
+ */
+struct CacheConfig {
+    std::size_t memory_mb = 256;       /**< 内存预算（MB），0 表示不在内存中缓存 */
+    std::string spill_dir;             /**< 溢出目录，为空表示不使用磁盘缓存 */
+    bool decode_cache = true;          /**< 是否在应用数据目录中缓存解码结果 */
+    std::size_t decode_cache_mb = 256; /**< 解码结果缓存的磁盘预算（MB），超出时删除最久未使用的结果 */
+
+    /**
+     * @brief 从配置文件加载缓存配置
+     * @param filename 配置文件路径
+     * @return 缓存配置
+     */
+    static CacheConfig loadFromConfig(const std::string &filename);
+};
+
+#endif // CACHECONFIG_H
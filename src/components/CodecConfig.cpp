@@ -0,0 +1,75 @@
+#include "CodecConfig.h"
+#include "../logging.h"
+#include <algorithm>
+#include <fstream>
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+using json = nlohmann::json;
+
+CodecConfig CodecConfig::loadFromConfig(const std::string &filename) {
+    CodecConfig config;
+
+    try {
+        std::ifstream file(filename);
+        if (!file.is_open()) {
+            spdlog::warn("Config file not found, using default codec config: {}", filename);
+            return config;
+        }
+
+        json configJson;
+        file >> configJson;
+
+        if (configJson.contains("codec")) {
+            const auto &codec = configJson["codec"];
+
+            if (codec.contains("chunk_size") && codec["chunk_size"].get<int>() > 0) {
+                config.chunk_size = codec["chunk_size"].get<std::size_t>();
+            }
+
+            if (codec.contains("compression_level")) {
+                config.compression_level = std::clamp(codec["compression_level"].get<int>(), 1, 9);
+            }
+
+            if (codec.contains("png_compression_level")) {
+                config.png_compression_level = std::clamp(codec["png_compression_level"].get<int>(), 0, 9);
+            }
+
+            if (codec.contains("decode_reduce_min_edge")) {
+                config.decode_reduce_min_edge = std::max(codec["decode_reduce_min_edge"].get<int>(), 0);
+            }
+
+            if (codec.contains("decode_tile_size")) {
+                config.decode_tile_size = std::max(codec["decode_tile_size"].get<int>(), 0);
+            }
+
+            if (codec.contains("decode_multi_symbol")) {
+                config.decode_multi_symbol = codec["decode_multi_symbol"].get<bool>();
+            }
+
+            if (codec.contains("io_threads") && codec["io_threads"].get<int>() > 0) {
+                config.io_threads = codec["io_threads"].get<int>();
+            }
+
+            if (codec.contains("timing_json")) {
+                config.timing_json = codec["timing_json"].get<bool>();
+            }
+
+            spdlog::info("Loaded codec config: chunk_size={}, compression_level={}, png_compression_level={}, "
+                         "decode_reduce_min_edge={}, decode_tile_size={}, decode_multi_symbol={}, io_threads={}, "
+                         "timing_json={}",
+                         config.chunk_size,
+                         config.compression_level,
+                         config.png_compression_level,
+                         config.decode_reduce_min_edge,
+                         config.decode_tile_size,
+                         config.decode_multi_symbol,
+                         config.io_threads,
+                         config.timing_json);
+        } else {
+            spdlog::info("No codec section in config, using defaults");
+        }
+    } catch (const std::exception &e) { spdlog::error("Failed to load codec config: {}", e.what()); }
+
+    return config;
+}
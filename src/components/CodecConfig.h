@@ -0,0 +1,28 @@
+#ifndef CODECCONFIG_H
+#define CODECCONFIG_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief 编码配置结构体
+ */
+struct CodecConfig {
+    std::size_t chunk_size = 1024;     /**< 分块生成时每个分块的数据长度（字节），需小于所选条码格式的容量 */
+    int compression_level = 6;         /**< 压缩级别（1~9），越大压缩率越高、速度越慢 */
+    int png_compression_level = 6;     /**< 保存 PNG 时的 zlib 压缩级别（0~9） */
+    int decode_reduce_min_edge = 1024; /**< 大图先缩小识别，缩小后的长边不小于该值（像素），0 表示不缩小 */
+    int decode_tile_size = 2048;       /**< 大图分块并行识别的块大小（像素），0 表示不分块 */
+    bool decode_multi_symbol = false;  /**< 一页多个标签：不做缩小识别，只按原分辨率识别，不漏掉较小的条码 */
+    int io_threads = 4;                /**< 批处理中读写文件的线程数，与计算线程分开 */
+    bool timing_json = false;          /**< 批处理结束后把各阶段的耗时汇总写入输出目录（lab2qrcode_timing.json） */
+
+    /**
+     * @brief 从配置文件加载编码配置
+     * @param filename 配置文件路径
+     * @return 编码配置
+     */
+    static CodecConfig loadFromConfig(const std::string &filename);
+};
+
+#endif // CODECCONFIG_H
@@ -0,0 +1,232 @@
+#include "PayloadView.h"
+#include <QFontDatabase>
+#include <QFutureWatcher>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+constexpr int hexBytesPerLine = 16; /**< 十六进制模式每行的字节数 */
+constexpr int hexLineChars = 78;    /**< 十六进制模式每行的字符数 */
+constexpr int wrapBytes = 512;      /**< 文本模式中超过该字节数的行折行显示 */
+constexpr int textMargin = 8;       /**< 内容与边框的距离 */
+
+/**
+ * @brief 后台分析的结果
+ */
+struct PayloadLayout {
+    bool binary = false;
+    std::vector<int> lines;
+    int longest = 0;
+};
+
+// 严格的 UTF-8 校验：拒绝过长编码、代理项与超出范围的码点
+bool isValidUtf8(const uchar *s, int n) {
+    int i = 0;
+    while (i < n) {
+        const uchar c = s[i];
+        if (c < 0x80) {
+            ++i;
+            continue;
+        }
+        const int len = (c >> 5) == 0x6 ? 2 : (c >> 4) == 0xE ? 3 : (c >> 3) == 0x1E ? 4 : 0;
+        if (len == 0 || i + len > n) {
+            return false;
+        }
+        char32_t cp = c & (0x7F >> len);
+        for (int k = 1; k < len; ++k) {
+            if ((s[i + k] & 0xC0) != 0x80) {
+                return false;
+            }
+            cp = (cp << 6) | (s[i + k] & 0x3F);
+        }
+        static constexpr char32_t minimum[] = {0, 0, 0x80, 0x800, 0x10000};
+        if (cp < minimum[len] || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF)) {
+            return false;
+        }
+        i += len;
+    }
+    return true;
+}
+
+PayloadLayout analyze(const QByteArray &data) {
+    PayloadLayout layout;
+    const auto *bytes = reinterpret_cast<const uchar *>(data.constData());
+    const int n = data.size();
+
+    // 含有 NUL、无效的 UTF-8 或超过 1% 的控制字符时按二进制处理
+    int controls = 0;
+    bool nul = false;
+    for (int i = 0; i < n; ++i) {
+        const uchar c = bytes[i];
+        if (c < 0x20 && c != '\t' && c != '\n' && c != '\r' && c != '\f' && c != 0x1B) {
+            ++controls;
+            nul = nul || c == 0;
+        }
+    }
+    layout.binary = nul || controls > n / 100 || !isValidUtf8(bytes, n);
+
+    // 按换行拆分，过长的行按 wrapBytes 折行，不拆开 UTF-8 多字节字符
+    const char *p = data.constData();
+    for (int start = 0; start < n;) {
+        layout.lines.push_back(start);
+        const int limit = std::min(n, start + wrapBytes);
+        int end = limit;
+        if (const void *newline = std::memchr(p + start, '\n', limit - start)) {
+            end = static_cast<int>(static_cast<const char *>(newline) - p) + 1;
+        } else if (limit < n) {
+            while (end > start + 1 && (static_cast<uchar>(p[end]) & 0xC0) == 0x80) {
+                --end;
+            }
+        }
+        layout.longest = std::max(layout.longest, end - start);
+        start = end;
+    }
+    return layout;
+}
+
+} // namespace
+
+PayloadView::PayloadView(QWidget *parent)
+    : QAbstractScrollArea(parent) {
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+}
+
+void PayloadView::setData(const QByteArray &data) {
+    // 再次显示同一份内容时保留显示方式与位置
+    if (data.constData() == data_.constData() && data.size() == data_.size() && !data.isNull()) {
+        return;
+    }
+    data_ = data;
+    lines_.clear();
+    longestLine_ = 0;
+    analyzed_ = false;
+    binary_ = false;
+    mode_ = Hex;
+    const quint64 generation = ++generation_;
+
+    auto *watcher = new QFutureWatcher<PayloadLayout>(this);
+    connect(watcher, &QFutureWatcher<PayloadLayout>::finished, this, [this, watcher, generation] {
+        watcher->deleteLater();
+        if (generation != generation_) {
+            return;
+        }
+        PayloadLayout layout = watcher->result();
+        lines_ = std::move(layout.lines);
+        longestLine_ = layout.longest;
+        binary_ = layout.binary;
+        analyzed_ = true;
+        setMode(binary_ ? Hex : Text);
+        emit analyzed();
+    });
+    watcher->setFuture(QtConcurrent::run([data = data_] { return analyze(data); }));
+
+    verticalScrollBar()->setValue(0);
+    horizontalScrollBar()->setValue(0);
+    updateScrollBars();
+    viewport()->update();
+}
+
+void PayloadView::setMode(Mode mode) {
+    if (mode_ == mode) {
+        return;
+    }
+    // 切换后大致停留在内容的同一位置
+    const double position = lineCount() > 0 ? static_cast<double>(verticalScrollBar()->value()) / lineCount() : 0;
+    mode_ = mode;
+    updateScrollBars();
+    verticalScrollBar()->setValue(static_cast<int>(position * lineCount()));
+    viewport()->update();
+}
+
+void PayloadView::paintEvent(QPaintEvent *event) {
+    QPainter painter(viewport());
+    painter.setFont(font());
+    painter.setPen(palette().color(QPalette::Text));
+
+    const QFontMetrics metrics(font());
+    const int lineHeight = metrics.lineSpacing();
+    const int first = verticalScrollBar()->value() + event->rect().top() / lineHeight;
+    const int last = std::min(lineCount() - 1, verticalScrollBar()->value() + event->rect().bottom() / lineHeight);
+    const int x = textMargin - horizontalScrollBar()->value();
+    for (int line = first; line <= last; ++line) {
+        const int y = (line - verticalScrollBar()->value()) * lineHeight + textMargin;
+        painter.drawText(x, y + metrics.ascent(), lineText(line));
+    }
+}
+
+void PayloadView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void PayloadView::scrollContentsBy(int, int) {
+    viewport()->update();
+}
+
+int PayloadView::lineCount() const {
+    if (mode_ == Hex) {
+        return (data_.size() + hexBytesPerLine - 1) / hexBytesPerLine;
+    }
+    return static_cast<int>(lines_.size());
+}
+
+QString PayloadView::lineText(int line) const {
+    if (mode_ == Hex) {
+        static constexpr char digits[] = "0123456789ABCDEF";
+        const int offset = line * hexBytesPerLine;
+        const int count = std::min(hexBytesPerLine, data_.size() - offset);
+        const auto *bytes = reinterpret_cast<const uchar *>(data_.constData()) + offset;
+
+        QString text = QString("%1  ").arg(offset, 8, 16, QChar('0')).toUpper();
+        text.reserve(hexLineChars);
+        for (int i = 0; i < hexBytesPerLine; ++i) {
+            if (i < count) {
+                text += QLatin1Char(digits[bytes[i] >> 4]);
+                text += QLatin1Char(digits[bytes[i] & 0xF]);
+                text += QLatin1Char(' ');
+            } else {
+                text += QLatin1String("   ");
+            }
+            if (i == hexBytesPerLine / 2 - 1) {
+                text += QLatin1Char(' ');
+            }
+        }
+        text += QLatin1String(" |");
+        for (int i = 0; i < count; ++i) {
+            text += bytes[i] >= 0x20 && bytes[i] < 0x7F ? QLatin1Char(static_cast<char>(bytes[i])) : QLatin1Char('.');
+        }
+        text += QLatin1Char('|');
+        return text;
+    }
+
+    const int start = lines_[line];
+    const int end = line + 1 < static_cast<int>(lines_.size()) ? lines_[line + 1] : data_.size();
+    QString text = QString::fromUtf8(data_.constData() + start, end - start);
+    // 行尾的换行符不显示，制表符按 4 个空格显示
+    while (text.endsWith(QLatin1Char('\n')) || text.endsWith(QLatin1Char('\r'))) {
+        text.chop(1);
+    }
+    text.replace(QLatin1Char('\t'), QLatin1String("    "));
+    return text;
+}
+
+void PayloadView::updateScrollBars() {
+    const QFontMetrics metrics(font());
+    const int lineHeight = metrics.lineSpacing();
+    const int visibleLines = std::max(1, (viewport()->height() - 2 * textMargin) / lineHeight);
+    verticalScrollBar()->setRange(0, std::max(0, lineCount() - visibleLines));
+    verticalScrollBar()->setPageStep(visibleLines);
+    verticalScrollBar()->setSingleStep(1);
+
+    // 等宽字体下按最长一行的字节数估算宽度：多字节字符的字节数不小于它的显示宽度
+    const int chars = mode_ == Hex ? hexLineChars : longestLine_;
+    const int width = chars * metrics.horizontalAdvance(QLatin1Char('0')) + 2 * textMargin;
+    horizontalScrollBar()->setRange(0, std::max(0, width - viewport()->width()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setSingleStep(metrics.horizontalAdvance(QLatin1Char('0')) * 4);
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QByteArray>
+#include <vector>
+
+/**
+ * @class PayloadView
+ * @brief 大段解码内容的查看器，直接从字节缓冲区按行绘制，支持十六进制与文本两种显示
+ *
+ * 内容不整体转换为 QString，也不交给 QLabel 排版：每次只把可见的几十行转换并绘制。
+ * 文本的行索引与 UTF-8/二进制判断在后台线程中完成，完成后自动选择显示方式（二进制内容为十六进制）并发出 analyzed。
+ */
+class PayloadView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 显示方式
+     */
+    enum Mode {
+        Hex,  /**< 偏移、十六进制与 ASCII，每行 16 字节 */
+        Text, /**< UTF-8 文本，过长的行自动折行 */
+    };
+
+    explicit PayloadView(QWidget *parent = nullptr);
+
+    /**
+     * @brief 显示内容（隐式共享，不复制），分析完成前按十六进制显示
+     */
+    void setData(const QByteArray &data);
+
+    /**
+     * @brief 切换显示方式，大致保持在内容的同一位置
+     */
+    void setMode(Mode mode);
+
+    [[nodiscard]] Mode mode() const noexcept {
+        return mode_;
+    }
+
+    [[nodiscard]] int size() const noexcept {
+        return data_.size();
+    }
+
+    /**
+     * @brief 后台分析是否已完成
+     */
+    [[nodiscard]] bool isAnalyzed() const noexcept {
+        return analyzed_;
+    }
+
+    /**
+     * @brief 内容是否为二进制（不是有效的 UTF-8，或含有较多控制字符），分析完成后有效
+     */
+    [[nodiscard]] bool isBinary() const noexcept {
+        return binary_;
+    }
+
+signals:
+    /**
+     * @brief 后台分析完成，显示方式已按内容选择
+     */
+    void analyzed();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    [[nodiscard]] int lineCount() const;
+    [[nodiscard]] QString lineText(int line) const;
+    void updateScrollBars();
+
+    QByteArray data_;
+    std::vector<int> lines_; /**< 文本模式下每行的起始偏移，分析完成前为空 */
+    int longestLine_ = 0;    /**< 文本模式下最长一行的字节数 */
+    bool analyzed_ = false;
+    bool binary_ = false;
+    Mode mode_ = Hex;
+    quint64 generation_ = 0; /**< setData 的次数，丢弃为旧内容完成的分析 */
+};
@@ -0,0 +1,283 @@
+#include "ResultView.h"
+#include <QCoreApplication>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QPainter>
+#include <QtConcurrent>
+#include <algorithm>
+
+namespace {
+
+constexpr int thumbnailThreads = 2;         /**< 生成缩略图的线程数 */
+constexpr int thumbnailBudgetKb = 64 << 10; /**< 缩略图缓存的内存预算（KB） */
+constexpr std::size_t maxQueued = 64;       /**< 等待生成的缩略图数上限，约为一屏可见的单元格数 */
+constexpr int previewChars = 256;           /**< 网格中文本内容的预览长度 */
+constexpr int cellMargin = 10;              /**< 单元格的外边距 */
+constexpr int cellSpacing = 5;              /**< 标题与内容之间的间距 */
+
+QFont titleFont(const QFont &base) {
+    QFont font = base;
+    font.setPointSize(10);
+    font.setBold(true);
+    return font;
+}
+
+} // namespace
+
+ResultListModel::ResultListModel(title_fn title, QObject *parent)
+    : QAbstractListModel(parent), title_(std::move(title)), thumbnails_(thumbnailBudgetKb) {
+    pool_.setMaxThreadCount(thumbnailThreads);
+    dispatchTimer_.setSingleShot(true);
+    dispatchTimer_.setInterval(0);
+    connect(&dispatchTimer_, &QTimer::timeout, this, &ResultListModel::dispatch);
+}
+
+void ResultListModel::setEntries(const std::vector<convert::result_data_entry> &entries) {
+    beginResetModel();
+    entries_ = entries;
+    // 缓存按图片保留，只丢弃针对旧行号的请求
+    queue_.clear();
+    waiting_.clear();
+    endResetModel();
+}
+
+void ResultListModel::append(std::vector<convert::result_data_entry>::const_iterator first,
+                             std::vector<convert::result_data_entry>::const_iterator last) {
+    if (first == last) {
+        return;
+    }
+    const int begin = static_cast<int>(entries_.size());
+    beginInsertRows({}, begin, begin + static_cast<int>(std::distance(first, last)) - 1);
+    entries_.insert(entries_.end(), first, last);
+    endInsertRows();
+}
+
+int ResultListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : static_cast<int>(entries_.size());
+}
+
+QVariant ResultListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rowCount()) {
+        return {};
+    }
+    const auto &entry = entries_[index.row()];
+    const auto *img = std::get_if<QImage>(&entry.data);
+    const auto *bytes = std::get_if<QByteArray>(&entry.data);
+    const auto *error = std::get_if<std::string>(&entry.data);
+
+    switch (role) {
+    case Qt::DisplayRole: return title_(entry);
+    case Qt::ToolTipRole: {
+        QString tip = entry.saved_path.isEmpty() ? entry.source_file_name : entry.saved_path;
+        if (img != nullptr && !img->isNull()) {
+            tip += QString("\nSize: %1x%2").arg(img->width()).arg(img->height());
+        }
+        return tip;
+    }
+    case Qt::DecorationRole:
+        if (img != nullptr && !img->isNull()) {
+            return thumbnail(index.row(), *img);
+        }
+        return {};
+    case KindRole:
+        if (img != nullptr) {
+            return img->isNull() ? Saved : Image;
+        }
+        return bytes ? Text : error ? Error : Empty;
+    case PreviewRole:
+        if (img != nullptr && img->isNull()) {
+            // 流式保存超出缩略图数量后只显示保存的文件名
+            return QCoreApplication::translate("BarcodeWidget", "已保存:\n%1")
+                .arg(QFileInfo(entry.saved_path).fileName());
+        }
+        if (bytes != nullptr) {
+            QString text = QString::fromUtf8(bytes->left(previewChars * 4));
+            if (text.length() > previewChars) {
+                text = text.left(previewChars) + "...";
+            }
+            return text;
+        }
+        if (error != nullptr) {
+            return QString::fromStdString(*error);
+        }
+        return {};
+    default: return {};
+    }
+}
+
+QPixmap ResultListModel::thumbnail(int row, const QImage &image) const {
+    const qint64 key = image.cacheKey();
+    if (const QPixmap *cached = thumbnails_.object(key)) {
+        return *cached;
+    }
+    auto &rows = waiting_[key];
+    if (rows.empty()) {
+        queue_.push_back({key, image});
+    }
+    if (std::ranges::find(rows, row) == rows.end()) {
+        rows.push_back(row);
+    }
+    if (!dispatchTimer_.isActive()) {
+        dispatchTimer_.start();
+    }
+    return {};
+}
+
+void ResultListModel::dispatch() {
+    // 快速滚动时早先请求的单元格多半已经滚出视图，只保留最近的请求
+    while (queue_.size() > maxQueued) {
+        waiting_.remove(queue_.front().key);
+        queue_.pop_front();
+    }
+
+    while (inFlight_ < pool_.maxThreadCount() && !queue_.empty()) {
+        request req = std::move(queue_.back());
+        queue_.pop_back();
+        ++inFlight_;
+
+        auto *watcher = new QFutureWatcher<QImage>(this);
+        connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, key = req.key] {
+            --inFlight_;
+            const QImage thumb = watcher->result();
+            watcher->deleteLater();
+
+            const int cost = std::max(1, static_cast<int>(thumb.sizeInBytes() >> 10));
+            thumbnails_.insert(key, new QPixmap(QPixmap::fromImage(thumb)), cost);
+            for (const int row : waiting_.take(key)) {
+                if (row < rowCount()) {
+                    emit dataChanged(index(row), index(row), {Qt::DecorationRole});
+                }
+            }
+            dispatch();
+        });
+        watcher->setFuture(QtConcurrent::run(&pool_, [image = std::move(req.image)] {
+            if (image.width() <= thumbnail_edge && image.height() <= thumbnail_edge) {
+                return image;
+            }
+            return image.scaled(thumbnail_edge, thumbnail_edge, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+        }));
+    }
+}
+
+void ResultGridDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    constexpr int edge = ResultListModel::thumbnail_edge;
+
+    painter->save();
+    painter->setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // 标题
+    const QFont font = titleFont(option.font);
+    const QFontMetrics metrics(font);
+    const QRect titleRect(option.rect.left() + cellMargin, option.rect.top() + cellMargin, edge, metrics.height());
+    painter->setFont(font);
+    painter->setPen(QColor("#333"));
+    painter->drawText(
+        titleRect, Qt::AlignCenter, metrics.elidedText(index.data(Qt::DisplayRole).toString(), Qt::ElideMiddle, edge));
+
+    // 内容
+    const QRect box(titleRect.left(), titleRect.bottom() + 1 + cellSpacing, edge, edge);
+    const int kind = index.data(ResultListModel::KindRole).toInt();
+    const bool error = kind == ResultListModel::Error;
+    painter->setPen(error ? QColor(Qt::red) : QColor("#ddd"));
+    painter->setBrush(error ? QColor("#fff0f0") : QColor(Qt::white));
+    painter->drawRect(box.adjusted(0, 0, -1, -1));
+
+    if (kind == ResultListModel::Image) {
+        // 缩略图还在生成时先留空，生成后模型通知视图重绘
+        const auto pixmap = index.data(Qt::DecorationRole).value<QPixmap>();
+        if (!pixmap.isNull()) {
+            QRect target(QPoint(), pixmap.size().scaled(box.size(), Qt::KeepAspectRatio).boundedTo(pixmap.size()));
+            target.moveCenter(box.center());
+            painter->drawPixmap(target, pixmap);
+        }
+    } else {
+        QFont textFont = option.font;
+        if (kind == ResultListModel::Text) {
+            textFont.setFamily("Consolas");
+        }
+        painter->setFont(textFont);
+        painter->setPen(error ? QColor(Qt::red) : QColor("#333"));
+        painter->drawText(box.adjusted(5, 5, -5, -5),
+                          Qt::AlignTop | Qt::AlignLeft | Qt::TextWrapAnywhere,
+                          index.data(ResultListModel::PreviewRole).toString());
+    }
+    painter->restore();
+}
+
+QSize ResultGridDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const {
+    constexpr int edge = ResultListModel::thumbnail_edge;
+    const int titleHeight = QFontMetrics(titleFont(option.font)).height();
+    return {edge + 2 * cellMargin, titleHeight + cellSpacing + edge + 2 * cellMargin};
+}
+
+void FileListModel::setRows(QVector<Row> rows) {
+    beginResetModel();
+    rows_ = std::move(rows);
+    endResetModel();
+}
+
+int FileListModel::rowCount(const QModelIndex &parent) const {
+    return parent.isValid() ? 0 : rows_.size();
+}
+
+QVariant FileListModel::data(const QModelIndex &index, int role) const {
+    if (!index.isValid() || index.row() >= rows_.size()) {
+        return {};
+    }
+    const Row &row = rows_[index.row()];
+    switch (role) {
+    case Qt::DisplayRole: return QFileInfo(row.path).fileName();
+    case Qt::ToolTipRole: return row.path; // 鼠标悬停显示完整路径
+    case Qt::DecorationRole: return row.icon;
+    case StatusRole: return row.status;
+    case StatusColorRole: return row.statusColor;
+    default: return {};
+    }
+}
+
+void FileRowDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const {
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    // 行容器，悬停时高亮
+    const bool hover = option.state.testFlag(QStyle::State_MouseOver);
+    const QRect rowRect = option.rect.adjusted(0, 0, -1, -1);
+    painter->setPen(hover ? QColor("#40a9ff") : QColor("#ccc"));
+    painter->setBrush(hover ? QColor("#f0f9ff") : QColor(Qt::white));
+    painter->drawRoundedRect(rowRect, 4, 4);
+
+    const QRect content = rowRect.adjusted(10, 8, -10, -8);
+
+    // 图标
+    const QRect iconRect(content.left(), content.center().y() - 12, 24, 24);
+    index.data(Qt::DecorationRole).value<QIcon>().paint(painter, iconRect);
+
+    // 操作提示
+    QFont statusFont = option.font;
+    statusFont.setPixelSize(12);
+    statusFont.setBold(true);
+    const QString status = index.data(FileListModel::StatusRole).toString();
+    const int statusWidth = QFontMetrics(statusFont).horizontalAdvance(status);
+    const QRect statusRect(content.right() - statusWidth, content.top(), statusWidth, content.height());
+    painter->setFont(statusFont);
+    painter->setPen(index.data(FileListModel::StatusColorRole).value<QColor>());
+    painter->drawText(statusRect, Qt::AlignVCenter | Qt::AlignRight, status);
+
+    // 文件名
+    QFont nameFont = option.font;
+    nameFont.setFamily("Consolas");
+    nameFont.setPixelSize(14);
+    const int nameLeft = iconRect.right() + 13;
+    const QRect nameRect(nameLeft, content.top(), statusRect.left() - 12 - nameLeft, content.height());
+    painter->setFont(nameFont);
+    painter->setPen(QColor("#333"));
+    painter->drawText(nameRect,
+                      Qt::AlignVCenter | Qt::AlignLeft,
+                      QFontMetrics(nameFont).elidedText(
+                          index.data(Qt::DisplayRole).toString(), Qt::ElideMiddle, nameRect.width()));
+    painter->restore();
+}
+
+QSize FileRowDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const {
+    return {option.rect.width(), 24 + 2 * 8 + 2};
+}
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QCache>
+#include <QColor>
+#include <QHash>
+#include <QIcon>
+#include <QImage>
+#include <QPixmap>
+#include <QStyledItemDelegate>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "../convert.h"
+
+/**
+ * @class ResultListModel
+ * @brief 批处理结果的列表模型，配合图标模式的 QListView 只绘制可见的单元格
+ *
+ * 条码的缩略图在视图请求 Qt::DecorationRole（即单元格可见）时才放入队列，由模型自己的线程池缩小生成，
+ * 生成后按图片缓存。最近请求的缩略图先生成；快速滚动时排队过多的早先请求被丢弃，再次显示时重新请求。
+ */
+class ResultListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        KindRole = Qt::UserRole, /**< 结果类型，见 Kind */
+        PreviewRole,             /**< 文本内容、错误信息或已保存文件的预览文字 */
+    };
+
+    /**
+     * @brief 结果类型
+     */
+    enum Kind {
+        Image, /**< 条码图片 */
+        Saved, /**< 流式保存后没有保留缩略图的条码 */
+        Text,  /**< 解码得到的内容 */
+        Error, /**< 错误信息 */
+        Empty, /**< 没有内容 */
+    };
+
+    static constexpr int thumbnail_edge = 200; /**< 缩略图的最大边长 */
+
+    using title_fn = std::function<QString(const convert::result_data_entry &)>;
+
+    /**
+     * @param title 单元格标题（文件名、条码序号与格式）
+     */
+    explicit ResultListModel(title_fn title, QObject *parent = nullptr);
+
+    /**
+     * @brief 替换全部结果
+     */
+    void setEntries(const std::vector<convert::result_data_entry> &entries);
+
+    /**
+     * @brief 在末尾追加结果，已有的行与视图的滚动位置不变
+     */
+    void append(std::vector<convert::result_data_entry>::const_iterator first,
+                std::vector<convert::result_data_entry>::const_iterator last);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    struct request {
+        qint64 key;   /**< 图片的 cacheKey */
+        QImage image; /**< 原图（隐式共享，不复制像素） */
+    };
+
+    // 返回缓存的缩略图；没有时放入生成队列，返回空图
+    [[nodiscard]] QPixmap thumbnail(int row, const QImage &image) const;
+
+    // 从队列末尾（最近的请求）开始生成，同时生成的数量不超过线程池的线程数
+    void dispatch();
+
+    title_fn title_;
+    std::vector<convert::result_data_entry> entries_;
+
+    QThreadPool pool_; /**< 缩略图专用，批处理占满全局线程池时也能及时生成 */
+    mutable QCache<qint64, QPixmap> thumbnails_;      /**< 按图片 cacheKey 缓存，代价单位为 KB */
+    mutable std::deque<request> queue_;               /**< 等待生成的请求，末尾为最近的请求 */
+    mutable QHash<qint64, std::vector<int>> waiting_; /**< 正在等待缩略图的行 */
+    mutable QTimer dispatchTimer_;                    /**< 合并同一次绘制中的请求 */
+    int inFlight_ = 0;                                /**< 正在生成的缩略图数 */
+};
+
+/**
+ * @class ResultGridDelegate
+ * @brief 绘制结果网格的单元格：标题在上，下方为缩略图、内容预览或错误信息
+ */
+class ResultGridDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    [[nodiscard]] QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+/**
+ * @class FileListModel
+ * @brief 已选择、等待处理的文件列表
+ */
+class FileListModel : public QAbstractListModel {
+    Q_OBJECT
+
+public:
+    /**
+     * @brief 自定义数据角色
+     */
+    enum Role {
+        StatusRole = Qt::UserRole, /**< 操作提示（待解码、待生成） */
+        StatusColorRole,           /**< 操作提示的颜色 */
+    };
+
+    /**
+     * @brief 一个文件
+     */
+    struct Row {
+        QString path;
+        QIcon icon;
+        QString status;
+        QColor statusColor;
+    };
+
+    using QAbstractListModel::QAbstractListModel;
+
+    /**
+     * @brief 替换全部文件
+     */
+    void setRows(QVector<Row> rows);
+
+    [[nodiscard]] int rowCount(const QModelIndex &parent = {}) const override;
+    [[nodiscard]] QVariant data(const QModelIndex &index, int role) const override;
+
+private:
+    QVector<Row> rows_;
+};
+
+/**
+ * @class FileRowDelegate
+ * @brief 绘制文件列表的一行：图标、文件名与右侧的操作提示
+ */
+class FileRowDelegate : public QStyledItemDelegate {
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+    [[nodiscard]] QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
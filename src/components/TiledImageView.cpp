@@ -0,0 +1,276 @@
+#include "TiledImageView.h"
+#include <QFutureWatcher>
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPaintEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QWheelEvent>
+#include <QtConcurrent>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr int tileSize = 256;            /**< 图块边长 */
+constexpr int bandRows = 512;            /**< 生成金字塔时每次处理的行数（偶数），限制临时内存 */
+constexpr int tileBudgetKb = 96 << 10;   /**< 图块缓存的内存预算（KB） */
+constexpr double maxZoom = 32.0;         /**< 最大放大倍数 */
+constexpr double wheelZoomStep = 1.0015; /**< 滚轮每 1/8 度的缩放倍数，触控板的细小滚动也能平滑缩放 */
+
+// 缩小一半，按条带处理：1 位的大图不会整体转换为 8 位或 32 位
+QImage halve(const QImage &source) {
+    const QImage::Format format =
+        source.isGrayscale() ? QImage::Format_Grayscale8 : QImage::Format_ARGB32_Premultiplied;
+    QImage half((source.width() + 1) / 2, (source.height() + 1) / 2, format);
+    for (int y = 0; y < source.height(); y += bandRows) {
+        const int rows = std::min(bandRows, source.height() - y);
+        const QImage band = source.copy(0, y, source.width(), rows).convertToFormat(format);
+        const QImage small =
+            band.scaled(half.width(), (rows + 1) / 2, Qt::IgnoreAspectRatio, Qt::SmoothTransformation)
+                .convertToFormat(format);
+        const auto bytes = static_cast<std::size_t>(std::min(half.bytesPerLine(), small.bytesPerLine()));
+        for (int row = 0; row < small.height() && y / 2 + row < half.height(); ++row) {
+            std::memcpy(half.scanLine(y / 2 + row), small.constScanLine(row), bytes);
+        }
+    }
+    return half;
+}
+
+// 逐级缩小一半，直到一级只有一个图块
+std::vector<QImage> buildPyramid(const QImage &image) {
+    std::vector<QImage> mips;
+    const QImage *previous = &image;
+    while (std::max(previous->width(), previous->height()) > tileSize) {
+        mips.push_back(halve(*previous));
+        previous = &mips.back();
+    }
+    return mips;
+}
+
+} // namespace
+
+TiledImageView::TiledImageView(QWidget *parent)
+    : QAbstractScrollArea(parent), tiles_(tileBudgetKb) {
+    setFocusPolicy(Qt::WheelFocus);
+    viewport()->setCursor(Qt::OpenHandCursor);
+}
+
+void TiledImageView::setImage(const QImage &image) {
+    // 再次显示同一张图片时保留缩放与位置
+    if (!image.isNull() && image.cacheKey() == image_.cacheKey()) {
+        return;
+    }
+    image_ = image;
+    mips_.clear();
+    tiles_.clear();
+    const quint64 generation = ++generation_;
+
+    const bool larger = image_.width() > viewport()->width() || image_.height() > viewport()->height();
+    setFit(larger);
+    if (!larger) {
+        zoom_ = 1.0;
+        updateScrollBars();
+    }
+
+    // 金字塔在后台生成，完成前缩小显示时直接使用原图的图块
+    if (std::max(image_.width(), image_.height()) > tileSize) {
+        auto *watcher = new QFutureWatcher<std::vector<QImage>>(this);
+        connect(watcher, &QFutureWatcher<std::vector<QImage>>::finished, this, [this, watcher, generation] {
+            if (generation == generation_) {
+                mips_ = watcher->result();
+                viewport()->update();
+            }
+            watcher->deleteLater();
+        });
+        watcher->setFuture(QtConcurrent::run([image = image_] { return buildPyramid(image); }));
+    }
+    viewport()->update();
+}
+
+void TiledImageView::paintEvent(QPaintEvent *event) {
+    if (image_.isNull()) {
+        return;
+    }
+    QPainter painter(viewport());
+
+    const int lv = level();
+    const QImage &source = lv == 0 ? image_ : mips_[lv - 1];
+    const double scale = zoom_ * std::ldexp(1.0, lv); // 该级像素到屏幕像素
+    // 放大时保持模块边缘锐利，缩小时平滑
+    painter.setRenderHint(QPainter::SmoothPixmapTransform, scale < 1.0);
+
+    // 重绘区域对应的该级图像范围
+    const QPointF origin = imageOrigin();
+    const QRectF dirty = event->rect();
+    const QRect area = QRectF((dirty.left() - origin.x()) / scale,
+                              (dirty.top() - origin.y()) / scale,
+                              dirty.width() / scale,
+                              dirty.height() / scale)
+                           .toAlignedRect() &
+                       source.rect();
+    if (area.isEmpty()) {
+        return;
+    }
+    for (int ty = area.top() / tileSize; ty <= area.bottom() / tileSize; ++ty) {
+        for (int tx = area.left() / tileSize; tx <= area.right() / tileSize; ++tx) {
+            const QRect rect = QRect(tx * tileSize, ty * tileSize, tileSize, tileSize) & source.rect();
+            const QRectF target(origin.x() + rect.x() * scale,
+                                origin.y() + rect.y() * scale,
+                                rect.width() * scale,
+                                rect.height() * scale);
+            painter.drawPixmap(target, tile(lv, source, rect), QRectF(0, 0, rect.width(), rect.height()));
+        }
+    }
+}
+
+void TiledImageView::resizeEvent(QResizeEvent *event) {
+    QAbstractScrollArea::resizeEvent(event);
+    if (fit_) {
+        zoom_ = fitZoom();
+    }
+    updateScrollBars();
+}
+
+void TiledImageView::scrollContentsBy(int, int) {
+    viewport()->update();
+}
+
+void TiledImageView::wheelEvent(QWheelEvent *event) {
+    if (!event->modifiers().testFlag(Qt::ControlModifier)) {
+        QAbstractScrollArea::wheelEvent(event);
+        return;
+    }
+    zoomAt(std::pow(wheelZoomStep, event->angleDelta().y()), event->position());
+    event->accept();
+}
+
+void TiledImageView::mousePressEvent(QMouseEvent *event) {
+    if (event->button() != Qt::LeftButton) {
+        QAbstractScrollArea::mousePressEvent(event);
+        return;
+    }
+    dragging_ = true;
+    dragStart_ = event->pos();
+    scrollStart_ = {horizontalScrollBar()->value(), verticalScrollBar()->value()};
+    viewport()->setCursor(Qt::ClosedHandCursor);
+}
+
+void TiledImageView::mouseMoveEvent(QMouseEvent *event) {
+    if (!dragging_) {
+        QAbstractScrollArea::mouseMoveEvent(event);
+        return;
+    }
+    const QPoint delta = event->pos() - dragStart_;
+    horizontalScrollBar()->setValue(scrollStart_.x() - delta.x());
+    verticalScrollBar()->setValue(scrollStart_.y() - delta.y());
+}
+
+void TiledImageView::mouseReleaseEvent(QMouseEvent *event) {
+    if (event->button() == Qt::LeftButton && dragging_) {
+        dragging_ = false;
+        viewport()->setCursor(Qt::OpenHandCursor);
+        return;
+    }
+    QAbstractScrollArea::mouseReleaseEvent(event);
+}
+
+void TiledImageView::mouseDoubleClickEvent(QMouseEvent *event) {
+    if (fit_) {
+        zoomAt(1.0 / zoom_, event->pos());
+    } else {
+        setFit(true);
+    }
+}
+
+void TiledImageView::keyPressEvent(QKeyEvent *event) {
+    const QPointF center = viewport()->rect().center();
+    switch (event->key()) {
+    case Qt::Key_Plus:
+    case Qt::Key_Equal: zoomAt(1.25, center); break;
+    case Qt::Key_Minus: zoomAt(1 / 1.25, center); break;
+    case Qt::Key_0: setFit(true); break;
+    case Qt::Key_1: zoomAt(1.0 / zoom_, center); break;
+    default: QAbstractScrollArea::keyPressEvent(event); return;
+    }
+    event->accept();
+}
+
+void TiledImageView::zoomAt(double factor, const QPointF &anchor) {
+    if (image_.isNull()) {
+        return;
+    }
+    const QPointF point = (anchor - imageOrigin()) / zoom_;
+    zoom_ = std::clamp(zoom_ * factor, std::min(fitZoom(), 1.0), maxZoom);
+    fit_ = false;
+    updateScrollBars();
+    // 缩放后光标下仍是同一处图像
+    horizontalScrollBar()->setValue(qRound(point.x() * zoom_ - anchor.x()));
+    verticalScrollBar()->setValue(qRound(point.y() * zoom_ - anchor.y()));
+    viewport()->update();
+}
+
+void TiledImageView::setFit(bool fit) {
+    fit_ = fit;
+    if (fit_) {
+        zoom_ = fitZoom();
+        updateScrollBars();
+        viewport()->update();
+    }
+}
+
+double TiledImageView::fitZoom() const {
+    if (image_.isNull()) {
+        return 1.0;
+    }
+    // 视口还没有布局（尺寸为 0）时也保证比例为正
+    const QSize view = viewport()->size().expandedTo({1, 1});
+    return std::min({static_cast<double>(view.width()) / image_.width(),
+                     static_cast<double>(view.height()) / image_.height(),
+                     maxZoom});
+}
+
+void TiledImageView::updateScrollBars() {
+    const QSize content(qRound(image_.width() * zoom_), qRound(image_.height() * zoom_));
+    const QSize view = viewport()->size();
+    horizontalScrollBar()->setRange(0, std::max(0, content.width() - view.width()));
+    horizontalScrollBar()->setPageStep(view.width());
+    horizontalScrollBar()->setSingleStep(20);
+    verticalScrollBar()->setRange(0, std::max(0, content.height() - view.height()));
+    verticalScrollBar()->setPageStep(view.height());
+    verticalScrollBar()->setSingleStep(20);
+}
+
+QPointF TiledImageView::imageOrigin() const {
+    const QSizeF content(image_.width() * zoom_, image_.height() * zoom_);
+    const QSize view = viewport()->size();
+    const double x = content.width() < view.width() ? (view.width() - content.width()) / 2
+                                                    : -horizontalScrollBar()->value();
+    const double y = content.height() < view.height() ? (view.height() - content.height()) / 2
+                                                      : -verticalScrollBar()->value();
+    return {x, y};
+}
+
+int TiledImageView::level() const {
+    // 选择不小于当前缩放的最小一级，绘制时只需缩小不到一半
+    int lv = 0;
+    while (lv < static_cast<int>(mips_.size()) && std::ldexp(1.0, -(lv + 1)) >= zoom_) {
+        ++lv;
+    }
+    return lv;
+}
+
+QPixmap TiledImageView::tile(int level, const QImage &source, const QRect &rect) {
+    const quint64 key = (static_cast<quint64>(level) << 48) | (static_cast<quint64>(rect.y() / tileSize) << 24) |
+                        static_cast<quint64>(rect.x() / tileSize);
+    if (const QPixmap *cached = tiles_.object(key)) {
+        return *cached;
+    }
+    // 只复制一个图块的像素
+    auto *pixmap = new QPixmap(QPixmap::fromImage(source.copy(rect)));
+    const QPixmap result = *pixmap;
+    const int cost = std::max(1, pixmap->width() * pixmap->height() * pixmap->depth() / 8 >> 10);
+    tiles_.insert(key, pixmap, cost);
+    return result;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <QAbstractScrollArea>
+#include <QCache>
+#include <QImage>
+#include <QPixmap>
+#include <QPoint>
+#include <vector>
+
+/**
+ * @class TiledImageView
+ * @brief 可缩放、拖动的大图查看器，只绘制可见的图块
+ *
+ * 原图只保留一份（QImage 隐式共享，不复制），不会整体转换为 QPixmap。后台线程逐级生成缩小一半的金字塔，
+ * 绘制时按当前缩放选择最接近的一级，只把可见范围内的 256×256 图块转换为 QPixmap 并缓存。
+ * Ctrl+滚轮或 +/- 键以光标为中心缩放，左键拖动平移，双击在适应窗口与 100% 之间切换。
+ */
+class TiledImageView : public QAbstractScrollArea {
+    Q_OBJECT
+
+public:
+    explicit TiledImageView(QWidget *parent = nullptr);
+
+    /**
+     * @brief 显示图片：比视口小时按 100% 显示，否则适应窗口
+     */
+    void setImage(const QImage &image);
+
+    /**
+     * @brief 当前缩放比例（屏幕像素 / 图片像素）
+     */
+    [[nodiscard]] double zoom() const noexcept {
+        return zoom_;
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void scrollContentsBy(int dx, int dy) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void mouseDoubleClickEvent(QMouseEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    // 以视口中的 anchor 为中心把缩放比例乘以 factor
+    void zoomAt(double factor, const QPointF &anchor);
+    void setFit(bool fit);
+    [[nodiscard]] double fitZoom() const;
+    void updateScrollBars();
+    // 原图左上角在视口中的位置，图片比视口小时居中
+    [[nodiscard]] QPointF imageOrigin() const;
+    // 当前缩放下使用的金字塔级别，0 为原图
+    [[nodiscard]] int level() const;
+    [[nodiscard]] QPixmap tile(int level, const QImage &source, const QRect &rect);
+
+    QImage image_;                   /**< 原图 */
+    std::vector<QImage> mips_;       /**< 金字塔：mips_[i] 为原图的 1/2^(i+1)，后台生成完成前为空 */
+    QCache<quint64, QPixmap> tiles_; /**< 按（级别、图块位置）缓存的图块，代价单位为 KB */
+    quint64 generation_ = 0;         /**< setImage 的次数，丢弃为旧图片生成的金字塔 */
+    double zoom_ = 1.0;              /**< 屏幕像素 / 图片像素 */
+    bool fit_ = false;               /**< 是否随视口大小适应窗口 */
+    QPoint dragStart_;               /**< 拖动开始时的光标位置 */
+    QPoint scrollStart_;             /**< 拖动开始时的滚动位置 */
+    bool dragging_ = false;          /**< 是否正在拖动平移 */
+};
@@ -5,18 +5,51 @@
 #ifndef LAB2QRCODE_CONVERT_H
 #define LAB2QRCODE_CONVERT_H
 
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <unordered_map>
 #include <variant>
 #include <vector>
 
 #include <QByteArray>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
 #include <QFileInfo>
 #include <QImage>
+#include <QRegularExpression>
 #include <QString>
+#include <QtConcurrent>
+#include <SimpleBase64.h>
+#include <ZXing/BarcodeFormat.h>
 #include <ZXing/BitMatrix.h>
+#include <ZXing/CharacterSet.h>
 #include <ZXing/ImageView.h>
 #include <ZXing/MultiFormatWriter.h>
+#include <ZXing/Quadrilateral.h>
 #include <ZXing/ReadBarcode.h>
 #include <opencv2/opencv.hpp>
+#include <spdlog/spdlog.h>
+
+#include "codec/chunk.h"
+#include "codec/decode_cache.h"
+#include "codec/envelope.h"
+#include "codec/image_cache.h"
+#include "codec/image_loader.h"
+#include "codec/pipeline.h"
+#include "codec/png_writer.h"
+#include "codec/raster.h"
+#include "codec/symbol.h"
+#include "codec/tiles.h"
+#include "codec/timing.h"
+#include "codec/vector_writer.h"
 
 /**
  * @namespace convert
@@ -24,30 +57,72 @@
  */
 namespace convert {
 
+/**
+ * @brief 解码级联中识别成功的层级，见 QRcode_to_byte
+ */
+enum class decode_tier {
+    none,   /**< 未识别（或不是解码结果） */
+    pure,   /**< 纯净条码快速识别：只查找指定格式，假定图像只有条码本身 */
+    hinted, /**< 指定格式的常规识别 */
+    full,   /**< 全部格式，尝试旋转、反色等的完整搜索 */
+};
+
+/**
+ * @brief 解码层级的名称，用于日志与命令行输出
+ */
+[[nodiscard]] constexpr const char *decode_tier_name(decode_tier tier) noexcept {
+    switch (tier) {
+    case decode_tier::pure: return "pure";
+    case decode_tier::hinted: return "hinted";
+    case decode_tier::full: return "full";
+    default: return "none";
+    }
+}
+
 struct result_data_entry {
-    using variant_t = std::variant<std::monostate, QImage, QByteArray, std::string>;
+    using variant_t = std::variant<std::monostate, QImage, QByteArray, std::string, chunk_fragment>;
 
-    //Empty, QRCode, decoded text, error
+    //Empty, QRCode, decoded text, error, chunk waiting for reassembly
     QString source_file_name;
     variant_t data;
+    int chunk_index = 0;                         /**< 分块序号（从1开始），0 表示未分块 */
+    int chunk_count = 0;                         /**< 分块总数 */
+    std::vector<result_data_entry> parts;        /**< 一个输入产生的多个子结果（如分块生成的多张条码） */
+    std::shared_ptr<const vector_symbol> vector; /**< 生成的条码的模块矩阵，用于 SVG/PDF 输出，见 save_symbol */
+    decode_tier tier = decode_tier::none;        /**< 解码时识别成功的层级 */
+    ZXing::BarcodeFormat barcode_format{};       /**< 解码得到的条码格式，未解码时为 None */
+    ZXing::Position position{};                  /**< 解码得到的条码在图中的四个角点 */
+    int symbol_index = 0;                        /**< 一张图中有多个条码时的序号（从1开始），0 表示只有一个 */
+    int symbol_count = 0;                        /**< 一张图中识别到的条码数 */
+    int page = 0;                                /**< 来自多页图片的第几页（从1开始），0 表示单页图片 */
+    QString saved_path;                          /**< 流式批处理中已写入的文件，见 stream_result */
 
     [[nodiscard]] result_data_entry() = default;
 
     [[nodiscard]] result_data_entry(const QString &source_file_name, const variant_t &data)
         : source_file_name(source_file_name), data(data) {}
 
-    [[nodiscard]] QString get_default_target_name() const {
+    /**
+     * @brief 保存结果时的默认文件名
+     * @param image_suffix 条码的保存格式（png、svg 或 pdf）
+     */
+    [[nodiscard]] QString get_default_target_name(const QString &image_suffix = "png") const {
         if (std::holds_alternative<QImage>(data)) {
-            if (!source_file_name.isEmpty()) {
-                return QFileInfo(source_file_name).baseName() + ".png";
+            const QString base = source_file_name.isEmpty() ? "qrcode" : QFileInfo(source_file_name).baseName();
+            if (chunk_count > 0) {
+                return QString("%1_%2.%3").arg(base).arg(chunk_index, 4, 10, QChar('0')).arg(image_suffix);
             }
-            return "qrcode.png";
+            return base + "." + image_suffix;
         }
         if (std::holds_alternative<QByteArray>(data)) {
-            if (!source_file_name.isEmpty()) {
-                return QFileInfo(source_file_name).completeBaseName() + ".rfa";
+            QString base = source_file_name.isEmpty() ? "decoded" : QFileInfo(source_file_name).completeBaseName();
+            if (page > 0) {
+                base += QString("_p%1").arg(page, 3, 10, QChar('0'));
+            }
+            if (symbol_count > 0) {
+                return QString("%1_%2.rfa").arg(base).arg(symbol_index, 2, 10, QChar('0'));
             }
-            return "decoded.rfa";
+            return base + ".rfa";
         }
 
         return {};
@@ -82,24 +157,51 @@ struct QRcode_create_config {
     int margin = 1;
 };
 
-[[nodiscard]] inline QImage byte_to_QRCode_qimage(const std::string &text, const QRcode_create_config qrcode_config) {
+/**
+ * @brief 生成条码的模块矩阵（每模块1位，含静区）
+ * @param text 条码内容
+ * @param qrcode_config 条码参数，只使用其中的格式、边距与横竖方向
+ * @param binary 为 true 时 text 视为原始字节，以 ISO-8859-1 字节模式逐字节写入；否则按 UTF-8 文本编码
+ */
+[[nodiscard]] inline ZXing::BitMatrix encode_modules(const std::string &text,
+                                                     const QRcode_create_config &qrcode_config,
+                                                     bool binary = false) {
+    const stage_timer timer(batch_stage::encode);
     ZXing::MultiFormatWriter writer(qrcode_config.format);
     writer.setMargin(qrcode_config.margin);
 
-    const auto bitMatrix = writer.encode(text, qrcode_config.target_width, qrcode_config.target_height);
-    const auto width = bitMatrix.width();
-    const auto height = bitMatrix.height();
-
-    QImage image(width, height, QImage::Format_Grayscale8);
+    // 宽高传 0/1 仅用于告诉 zxing 目标的横竖方向（PDF417 会据此旋转），不做任何放大
+    const int orientationWidth = qrcode_config.target_width > qrcode_config.target_height ? 1 : 0;
+    const int orientationHeight = qrcode_config.target_height > qrcode_config.target_width ? 1 : 0;
 
-    for (int y = 0; y < height; ++y) {
-        uchar *line = image.scanLine(y);
-        for (int x = 0; x < width; ++x) {
-            line[x] = bitMatrix.get(x, y) ? 0x00 : std::numeric_limits<uchar>::max();
-        }
+    ZXing::BitMatrix modules;
+    if (binary) {
+        // 每个字节映射为一个 ISO-8859-1 字符，zxing 按字节模式原样写入，解码时由 bytes() 无损取回
+        std::wstring latin1(text.size(), L'\0');
+        std::ranges::transform(
+            text, latin1.begin(), [](char c) { return static_cast<wchar_t>(static_cast<unsigned char>(c)); });
+        writer.setEncoding(ZXing::CharacterSet::ISO8859_1);
+        modules = writer.encode(latin1, orientationWidth, orientationHeight);
+    } else {
+        modules = writer.encode(text, orientationWidth, orientationHeight);
     }
+    return modules;
+}
 
-    return image;
+/**
+ * @brief 生成条码图片
+ * @param text 条码内容
+ * @param qrcode_config 条码参数，输出图片精确为 target_width×target_height
+ * @param binary 见 encode_modules
+ *
+ * @details zxing 只输出每模块1像素的模块矩阵，再由 rasterize_bitmatrix 直接按整数倍复制到目标尺寸，
+ *          避免先由 zxing 放大、再逐像素拷贝、最后平滑缩放的多次整图遍历。
+ */
+[[nodiscard]] inline QImage byte_to_QRCode_qimage(const std::string &text,
+                                                  const QRcode_create_config qrcode_config,
+                                                  bool binary = false) {
+    return rasterize_bitmatrix(
+        encode_modules(text, qrcode_config, binary), qrcode_config.target_width, qrcode_config.target_height);
 }
 
 /**
@@ -123,6 +225,7 @@ struct QRcode_create_config {
     }
 
     // 使用平滑缩放算法缩放到目标尺寸
+    const stage_timer timer(batch_stage::resize);
     return image.scaled(targetWidth, targetHeight, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
 }
 
@@ -134,6 +237,7 @@ struct result_i2t { //image to text result, 傻瓜式expected
     };
     std::string text{};
     errcode err{};
+    decode_tier tier = decode_tier::none; /**< 识别成功的层级 */
 
     [[nodiscard]] explicit(false) result_i2t(const std::string &text)
         : text(text) {}
@@ -149,23 +253,1239 @@ struct result_i2t { //image to text result, 傻瓜式expected
     }
 };
 
-[[nodiscard]] inline result_i2t QRcode_to_byte(const std::string &file_path) {
-    const cv::Mat img = cv::imread(file_path, cv::IMREAD_COLOR);
+/**
+ * @brief 取出识别结果的内容：二进制内容与分块按原始字节读取，其余内容按文本读取（保持 UTF-8 等字符集的兼容）
+ */
+[[nodiscard]] inline std::string barcode_content(const ZXing::Result &result) {
+    const auto &bytes = result.bytes();
+    const std::string_view raw(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+    if (is_envelope(raw) || is_chunk(raw)) {
+        return std::string(raw);
+    }
+    return result.text();
+}
+
+/**
+ * @brief 图像中识别到的一个条码
+ */
+struct decoded_symbol {
+    std::string text;                                         /**< 条码内容，见 barcode_content */
+    ZXing::BarcodeFormat format = ZXing::BarcodeFormat::None; /**< 条码格式 */
+    ZXing::Position position;                                 /**< 四个角点在整幅图像中的坐标 */
+    decode_tier tier = decode_tier::none;                     /**< 识别成功的层级 */
+};
+
+/**
+ * @brief 以指定的识别参数读取图像中的全部条码
+ * @param offset 图像是某个大图中的一块时，该块在大图中的位置，结果坐标换算到大图
+ */
+[[nodiscard]] inline std::vector<decoded_symbol> read_symbols(const ZXing::ImageView &image,
+                                                              const ZXing::ReaderOptions &options,
+                                                              decode_tier tier,
+                                                              QPoint offset = {}) {
+    std::vector<decoded_symbol> symbols;
+    for (const auto &result : ZXing::ReadBarcodes(image, options)) {
+        if (!result.isValid()) {
+            continue;
+        }
+        auto position = result.position();
+        for (auto &p : position) {
+            p.x += offset.x();
+            p.y += offset.y();
+        }
+        symbols.push_back({barcode_content(result), result.format(), position, tier});
+    }
+    return symbols;
+}
+
+/**
+ * @brief 同一个条码被相邻的重叠块重复识别时，两次结果内容相同且一个的中心落在另一个的范围内
+ */
+[[nodiscard]] inline bool same_symbol(const decoded_symbol &a, const decoded_symbol &b) {
+    if (a.format != b.format || a.text != b.text) {
+        return false;
+    }
+    const auto center = ZXing::Center(a.position);
+    int left = b.position[0].x, right = left, top = b.position[0].y, bottom = top;
+    for (const auto &p : b.position) {
+        left = std::min(left, p.x);
+        right = std::max(right, p.x);
+        top = std::min(top, p.y);
+        bottom = std::max(bottom, p.y);
+    }
+    return center.x >= left && center.x <= right && center.y >= top && center.y <= bottom;
+}
+
+/**
+ * @brief 将缩小的图像中识别到的条码坐标换算回原图
+ * @param factor 缩小倍数，坐标取缩小像素所覆盖区域的中心
+ */
+inline void scale_symbols(std::vector<decoded_symbol> &symbols, int factor) {
+    for (auto &symbol : symbols) {
+        for (auto &p : symbol.position) {
+            p.x = p.x * factor + factor / 2;
+            p.y = p.y * factor + factor / 2;
+        }
+    }
+}
+
+/**
+ * @brief 将 extra 中尚未出现在 symbols 中的条码加入 symbols，同一个条码只保留先加入的一次，见 same_symbol
+ */
+inline void merge_symbols(std::vector<decoded_symbol> &symbols, const std::vector<decoded_symbol> &extra) {
+    for (const auto &symbol : extra) {
+        const auto duplicate = std::ranges::any_of(symbols, [&symbol](const decoded_symbol &known) {
+            return same_symbol(symbol, known) || same_symbol(known, symbol);
+        });
+        if (!duplicate) {
+            symbols.push_back(symbol);
+        }
+    }
+}
+
+/**
+ * @brief 将条码按位置从上到下、从左到右排列
+ */
+inline void sort_symbols(std::vector<decoded_symbol> &symbols) {
+    std::ranges::sort(symbols, [](const decoded_symbol &a, const decoded_symbol &b) {
+        const auto ca = ZXing::Center(a.position);
+        const auto cb = ZXing::Center(b.position);
+        return std::pair(ca.y, ca.x) < std::pair(cb.y, cb.x);
+    });
+}
+
+/**
+ * @brief 将灰度大图切分为重叠的块，在线程池上并行识别，并合并重叠区域中重复识别的条码
+ * @param gray 单通道灰度图
+ * @param formats 优先尝试的条码格式，每块先按指定格式识别，找不到再完整搜索
+ * @param tile_size 块的边长，相邻块重叠四分之一，不超过该宽度的条码至少完整地落在一个块中
+ * @return 找到的条码，按位置从上到下、从左到右排列
+ *
+ * @details 各块在全局线程池上识别，块只引用原图的区域，不复制像素。批量解码已经占满线程池时，
+ *          blockingMapped 由当前线程依次完成自己的各块，线程总数仍不超过线程池上限，不会与按文件的并行相互争抢。
+ */
+[[nodiscard]] inline std::vector<decoded_symbol> read_tiles(const cv::Mat &gray,
+                                                           ZXing::BarcodeFormats formats,
+                                                           int tile_size) {
+    struct worker {
+        using result_type = std::vector<decoded_symbol>;
+
+        cv::Mat gray;
+        ZXing::BarcodeFormats formats;
+
+        std::vector<decoded_symbol> operator()(const QRect &tile) const {
+            const cv::Mat roi = gray(cv::Rect(tile.x(), tile.y(), tile.width(), tile.height()));
+            const ZXing::ImageView view(
+                roi.data, roi.cols, roi.rows, ZXing::ImageFormat::Lum, static_cast<int>(roi.step));
+
+            if (!formats.empty()) {
+                const auto hinted = ZXing::ReaderOptions().setFormats(formats).setTryDownscale(false);
+                if (auto symbols = read_symbols(view, hinted, decode_tier::hinted, tile.topLeft()); !symbols.empty()) {
+                    return symbols;
+                }
+            }
+            return read_symbols(view, ZXing::ReaderOptions(), decode_tier::full, tile.topLeft());
+        }
+    };
+
+    const auto tiles = split_tiles(QSize(gray.cols, gray.rows), tile_size, tile_size / 4);
+    const auto perTile =
+        QtConcurrent::blockingMapped<std::vector<std::vector<decoded_symbol>>>(tiles, worker{gray, formats});
+
+    std::vector<decoded_symbol> merged;
+    for (const auto &symbols : perTile) {
+        merge_symbols(merged, symbols);
+    }
+    sort_symbols(merged);
+    spdlog::debug("分块识别: {} 块, {} 个条码", tiles.size(), merged.size());
+    return merged;
+}
+
+/**
+ * @brief 按代价从低到高逐级识别整幅灰度图中的条码，见 find_symbols
+ */
+[[nodiscard]] inline std::vector<decoded_symbol> read_cascade(const cv::Mat &gray, ZXing::BarcodeFormats formats) {
+    const ZXing::ImageView imageView(
+        gray.data, gray.cols, gray.rows, ZXing::ImageFormat::Lum, static_cast<int>(gray.step));
+
+    std::vector<decoded_symbol> symbols;
+    if (!formats.empty()) {
+        const auto fast = ZXing::ReaderOptions()
+                              .setFormats(formats)
+                              .setTryHarder(false)
+                              .setTryRotate(false)
+                              .setTryInvert(false)
+                              .setTryDownscale(false);
+        symbols = read_symbols(imageView, ZXing::ReaderOptions(fast).setIsPure(true), decode_tier::pure);
+        if (symbols.empty()) {
+            symbols = read_symbols(imageView, fast, decode_tier::hinted);
+        }
+    }
+    if (symbols.empty()) {
+        symbols = read_symbols(imageView, ZXing::ReaderOptions(), decode_tier::full);
+    }
+    return symbols;
+}
+
+/**
+ * @brief 识别图像中的全部条码
+ * @param img 灰度或 BGR 图像
+ * @param formats 优先尝试的条码格式（通常是界面中选择的格式），为空时直接进行完整搜索
+ * @param tile_size 大图分块识别的块大小，0 表示不分块
+ * @return 找到的条码，按位置从上到下、从左到右排列
+ *
+ * @details 按代价从低到高逐级尝试，找到条码即返回，并在结果中记录成功的层级：
+ *          1. pure：只查找指定格式，假定图像只有条码本身（本程序生成的图片），不做旋转、反色与缩小；
+ *          2. hinted：只查找指定格式的常规识别；
+ *          3. full：全部格式，尝试旋转、反色与缩小的完整搜索（zxing 的默认参数）。
+ *          长边超过 tile_size 1.5 倍的大图先由 read_tiles 分块并行识别。大于块重叠宽度又跨越块边缘的条码不会完整地落在
+ *          任何一块中，因此再把整幅图像缩小到不超过块大小识别一次，与分块的结果合并。分块已覆盖原分辨率的全部像素，
+ *          不再单线程地按原分辨率识别整幅大图；未分块的图像直接按原分辨率识别。
+ */
+[[nodiscard]] inline std::vector<decoded_symbol> find_symbols(const cv::Mat &img,
+                                                              ZXing::BarcodeFormats formats = {},
+                                                              int tile_size = 0) {
     if (img.empty()) {
-        return result_i2t::empty_img;
+        return {};
     }
+    const stage_timer timer(batch_stage::barcode_read);
 
     cv::Mat grayImg;
-    cv::cvtColor(img, grayImg, cv::COLOR_BGR2GRAY);
+    if (img.channels() == 1) {
+        grayImg = img;
+    } else {
+        cv::cvtColor(img, grayImg, cv::COLOR_BGR2GRAY);
+    }
+
+    if (should_tile(QSize(grayImg.cols, grayImg.rows), tile_size)) {
+        auto symbols = read_tiles(grayImg, formats, tile_size);
+
+        const int factor = (std::max(grayImg.cols, grayImg.rows) + tile_size - 1) / tile_size;
+        cv::Mat whole;
+        cv::resize(grayImg, whole, cv::Size(), 1.0 / factor, 1.0 / factor, cv::INTER_AREA);
+        auto large = read_cascade(whole, formats);
+        scale_symbols(large, factor);
+        merge_symbols(symbols, large);
+        spdlog::debug("整幅图像以 1/{} 分辨率识别: {} 个条码，合并后共 {} 个", factor, large.size(), symbols.size());
+        sort_symbols(symbols);
+        return symbols;
+    }
 
-    const ZXing::ImageView imageView(grayImg.data, grayImg.cols, grayImg.rows, ZXing::ImageFormat::Lum);
-    const auto result = ZXing::ReadBarcode(imageView);
+    auto symbols = read_cascade(grayImg, formats);
+    sort_symbols(symbols);
+    return symbols;
+}
 
-    if (!result.isValid()) {
+/**
+ * @brief 识别图像中的条码，图中有多个条码时只返回位置最靠上、靠左的一个
+ * @see find_symbols
+ */
+[[nodiscard]] inline result_i2t QRcode_to_byte(const cv::Mat &img,
+                                               ZXing::BarcodeFormats formats = {},
+                                               int tile_size = 0) {
+    if (img.empty()) {
+        return result_i2t::empty_img;
+    }
+    auto symbols = find_symbols(img, formats, tile_size);
+    if (symbols.empty()) {
         return result_i2t::invalid_qrcode;
     }
+    result_i2t rst(std::move(symbols.front().text));
+    rst.tier = symbols.front().tier;
+    return rst;
+}
 
-    return result.text();
+[[nodiscard]] inline result_i2t QRcode_to_byte(const std::string &file_path) {
+    const mapped_image_file file(QString::fromStdString(file_path));
+    return QRcode_to_byte(decode_grayscale(file.data(), file.size()));
+}
+
+/**
+ * @brief 文件到条码的完整生成参数
+ */
+struct encode_options {
+    QRcode_create_config qrcode{}; /**< 条码参数，其中宽高即最终输出尺寸 */
+    int ppi = 300;                 /**< 写入图片的PPI元数据 */
+    bool use_base64 = true;        /**< 生成前是否先进行Base64编码 */
+    bool binary = false;           /**< 二进制模式：跳过Base64，以字节模式直接写入原始数据，优先于 use_base64 */
+    bool compress = false;         /**< 压缩后更小时先以 deflate 压缩，仅对 Base64 与二进制模式生效 */
+    int compression_level = 6;     /**< zlib 压缩级别（1~9） */
+    std::size_t chunk_size = 0;    /**< 分块的数据长度，内容超过该长度时分块生成，0 表示不分块 */
+    bool rasterize = true;         /**< 是否生成位图；只需要 SVG/PDF 输出时关闭，跳过光栅化 */
+};
+
+/**
+ * @brief 尝试压缩数据
+ * @return 压缩后（含头部）比原始数据更小时返回带头部的压缩内容，否则返回 std::nullopt
+ */
+[[nodiscard]] inline std::optional<std::string> try_compress(const QByteArray &data, int level) {
+    const stage_timer timer(batch_stage::compress);
+    const QByteArray compressed = qCompress(data, level);
+    if (static_cast<std::size_t>(compressed.size()) + envelope_header_size >= static_cast<std::size_t>(data.size())) {
+        spdlog::debug("压缩无收益，保持原始数据: {} -> {} 字节", data.size(), compressed.size());
+        return std::nullopt;
+    }
+    spdlog::debug("压缩: {} -> {} 字节", data.size(), compressed.size());
+    return wrap_envelope({compressed.constData(), static_cast<std::size_t>(compressed.size())}, envelope_deflate);
+}
+
+/**
+ * @brief 拆开带头部的内容并按标志还原数据
+ * @throw std::runtime_error 标志无法识别或解压失败
+ */
+[[nodiscard]] inline QByteArray open_envelope(const envelope &env) {
+    if (env.flags & ~envelope_known_flags) {
+        throw std::runtime_error(QCoreApplication::translate("convert", "无法识别的内容头部，请使用新版本解码")
+                                     .toStdString());
+    }
+
+    QByteArray body(env.body.data(), static_cast<int>(env.body.size()));
+    if (env.flags & envelope_deflate) {
+        const stage_timer timer(batch_stage::compress);
+        body = qUncompress(body);
+        if (body.isEmpty()) {
+            throw std::runtime_error(QCoreApplication::translate("convert", "解压失败，数据可能已损坏").toStdString());
+        }
+    }
+    return body;
+}
+
+/**
+ * @brief 将原始字节转换为待写入条码的内容
+ *
+ * 二进制模式为带头部的原始字节，Base64 模式为 Base64 文本，否则为原样的文本。
+ * 启用压缩且压缩有收益时，二进制与 Base64 模式写入带压缩标志头部的数据；文本模式始终不压缩。
+ */
+[[nodiscard]] inline std::string make_payload(const QByteArray &data, const encode_options &options) {
+    if (!options.binary && !options.use_base64) {
+        return data.toStdString();
+    }
+
+    const auto packed = options.compress ? try_compress(data, options.compression_level) : std::nullopt;
+    if (options.binary) {
+        return packed ? *packed : wrap_envelope({data.constData(), static_cast<std::size_t>(data.size())});
+    }
+    const stage_timer timer(batch_stage::base64);
+    if (packed) {
+        return SimpleBase64::encode(reinterpret_cast<const std::uint8_t *>(packed->data()), packed->size());
+    }
+    return SimpleBase64::encode(reinterpret_cast<const std::uint8_t *>(data.constData()), data.size());
+}
+
+/**
+ * @brief make_payload 的逆过程，将条码内容还原为原始字节
+ * @param use_base64 内容不带头部时是否进行 Base64 解码，带头部的二进制内容会被自动识别
+ * @throw std::runtime_error 头部无法识别或解压失败
+ */
+[[nodiscard]] inline QByteArray parse_payload(const std::string &text, bool use_base64) {
+    if (const auto env = unwrap_envelope(text)) {
+        return open_envelope(*env);
+    }
+    if (use_base64) {
+        const auto decoded = [&] {
+            const stage_timer timer(batch_stage::base64);
+            return SimpleBase64::decode(text);
+        }();
+        const std::string_view view(reinterpret_cast<const char *>(decoded.data()), decoded.size());
+        if (const auto env = unwrap_envelope(view)) {
+            return open_envelope(*env);
+        }
+        return {view.data(), static_cast<int>(view.size())};
+    }
+    return {text.data(), static_cast<int>(text.size())};
+}
+
+/**
+ * @brief 条码图片缓存的键：条码内容与所有影响图片的生成参数的 SHA-1
+ */
+[[nodiscard]] inline QByteArray image_cache_key(const std::string &payload, const encode_options &options) {
+    const auto &qr = options.qrcode;
+    const QByteArray params = QByteArray::number(static_cast<int>(qr.format)) + '|' + QByteArray::number(qr.margin) +
+                              '|' + QByteArray::number(qr.target_width) + '|' + QByteArray::number(qr.target_height) +
+                              '|' + QByteArray::number(options.ppi) + '|' + (options.binary ? 'b' : 't') + '|';
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(params);
+    hash.addData(payload.data(), static_cast<int>(payload.size()));
+    return hash.result();
+}
+
+/**
+ * @brief 由条码内容生成条码：模块矩阵，以及写入了DPI元数据的精确尺寸图片
+ * @return 内容不符合条码格式要求时 zxing 会抛出异常
+ *
+ * @details 启用 image_cache 时，同样的内容与参数直接返回缓存的条码，不再编码与光栅化。
+ */
+[[nodiscard]] inline barcode_symbol payload_to_symbol(const std::string &payload, const encode_options &options) {
+    auto &cache = image_cache::instance();
+    QByteArray key;
+    if (cache.enabled()) {
+        key = image_cache_key(payload, options);
+        if (auto cached = cache.find(key)) {
+            return *std::move(cached);
+        }
+    }
+
+    const auto &qr = options.qrcode;
+    auto vector = std::make_shared<const vector_symbol>(
+        vector_symbol{encode_modules(payload, qr, options.binary), qr.target_width, qr.target_height, options.ppi});
+    if (vector->modules.width() <= 0) {
+        return {};
+    }
+
+    barcode_symbol symbol{{}, std::move(vector)};
+    if (options.rasterize) {
+        symbol.image = rasterize_bitmatrix(symbol.vector->modules, qr.target_width, qr.target_height);
+        if (symbol.image.isNull()) {
+            return {};
+        }
+        const int dpm = static_cast<int>(options.ppi / 0.0254);
+        symbol.image.setDotsPerMeterX(dpm);
+        symbol.image.setDotsPerMeterY(dpm);
+    }
+
+    if (!key.isEmpty()) {
+        cache.insert(key, symbol);
+    }
+    return symbol;
+}
+
+/**
+ * @brief 按 options 将原始字节生成单个条码（不分块）
+ */
+[[nodiscard]] inline barcode_symbol encode_bytes(const QByteArray &data, const encode_options &options) {
+    return payload_to_symbol(make_payload(data, options), options);
+}
+
+/**
+ * @brief 将生成的条码放入结果，生成失败时记录错误
+ */
+inline void set_symbol(result_data_entry &entry, barcode_symbol symbol) {
+    if (!symbol) {
+        entry.set_error(QCoreApplication::translate("convert", "生成图片失败"));
+        return;
+    }
+    entry.data = std::move(symbol.image);
+    entry.vector = std::move(symbol.vector);
+}
+
+/**
+ * @brief 将超过单个条码容量的内容切分为多个分块条码并行生成
+ * @return 结果的 parts 依次为各分块的条码图片（或该分块的错误信息）
+ *
+ * @details 分块在全局线程池上并行编码。批处理已经占满线程池时，
+ *          blockingMapped 由当前线程依次完成所有分块，不会额外创建线程。
+ */
+[[nodiscard]] inline result_data_entry encode_chunks(const QString &source,
+                                                     const std::string &payload,
+                                                     const encode_options &options) {
+    struct worker {
+        using result_type = result_data_entry;
+
+        QString source;
+        encode_options options;
+
+        result_data_entry operator()(const std::string &chunk) const {
+            result_data_entry part{source, std::monostate{}};
+            try {
+                set_symbol(part, payload_to_symbol(chunk, options));
+            } catch (const std::exception &e) { part.set_error(e.what()); }
+            return part;
+        }
+    };
+
+    if (chunk_count(payload.size(), options.chunk_size) > static_cast<std::size_t>(max_chunk_count)) {
+        return {source,
+                QCoreApplication::translate("convert", "分块数超过上限 %1，请增大分块大小")
+                    .arg(max_chunk_count)
+                    .toStdString()};
+    }
+
+    // 分块边界可能切断多字节字符或二进制数据，分块一律按字节模式写入，解码时按原始字节取回
+    auto chunk_options = options;
+    chunk_options.binary = true;
+
+    const auto chunks = split_chunks(payload, options.chunk_size);
+    auto parts = QtConcurrent::blockingMapped<std::vector<result_data_entry>>(chunks, worker{source, chunk_options});
+
+    const int count = static_cast<int>(parts.size());
+    for (int i = 0; i < count; ++i) {
+        parts[i].chunk_index = i + 1;
+        parts[i].chunk_count = count;
+    }
+
+    result_data_entry res{source, std::monostate{}};
+    res.parts = std::move(parts);
+    return res;
+}
+
+/**
+ * @brief 由已经过 make_payload 处理的条码内容生成条码，内容超过 options.chunk_size 时自动分块
+ * @param source 来源名称，用于结果的默认文件名
+ */
+[[nodiscard]] inline result_data_entry encode_payload(const QString &source,
+                                                      const std::string &payload,
+                                                      const encode_options &options) {
+    result_data_entry res{source, std::monostate{}};
+    try {
+        if (options.chunk_size > 0 && payload.size() > options.chunk_size) {
+            return encode_chunks(source, payload, options);
+        }
+
+        set_symbol(res, payload_to_symbol(payload, options));
+    } catch (const std::exception &e) { res.set_error(e.what()); }
+    return res;
+}
+
+/**
+ * @brief 由原始字节生成条码，内容超过 options.chunk_size 时自动分块
+ * @param source 来源名称，用于结果的默认文件名
+ */
+[[nodiscard]] inline result_data_entry encode_data(const QString &source,
+                                                   const QByteArray &data,
+                                                   const encode_options &options) {
+    return encode_payload(source, make_payload(data, options), options);
+}
+
+/**
+ * @brief 生成流水线读取阶段的结果，见 load_encode_input
+ */
+struct loaded_encode_input {
+    loaded_file file;                   /**< 读入的原始数据，流式编码时 data 为空 */
+    std::optional<std::string> payload; /**< 流式编码时已经读取并 Base64 编码好的条码内容 */
+};
+
+/**
+ * @brief 是否按块读取文件并流式 Base64 编码：仅启用 Base64（不压缩、非二进制模式）时，条码内容只依赖逐块编码的结果
+ */
+[[nodiscard]] inline bool streams_base64(const encode_options &options) noexcept {
+    return options.use_base64 && !options.binary && !options.compress;
+}
+
+/**
+ * @brief 按块读取文件并流式 Base64 编码，不需要同时持有完整的原始数据与编码结果
+ */
+[[nodiscard]] inline std::string read_base64_payload(QFile &file) {
+    constexpr qint64 block_size = 3 * 64 * 1024;
+    std::string payload;
+    payload.reserve(static_cast<std::size_t>((file.size() + 2) / 3 * 4));
+
+    // 读取与编码交替进行，两个阶段的耗时分别累计
+    stage_accumulator reading(batch_stage::read);
+    stage_accumulator encoding(batch_stage::base64);
+    SimpleBase64::Encoder encoder;
+    QByteArray block(block_size, Qt::Uninitialized);
+    for (;;) {
+        reading.start();
+        const qint64 n = file.read(block.data(), block_size);
+        reading.stop();
+        if (n <= 0) {
+            break;
+        }
+        reading.add_bytes(n);
+        encoding.start();
+        encoder.update(reinterpret_cast<const std::uint8_t *>(block.constData()), static_cast<std::size_t>(n), payload);
+        encoding.stop();
+    }
+    encoding.start();
+    encoder.finish(payload);
+    encoding.stop();
+    return payload;
+}
+
+/**
+ * @brief 生成流水线的读取阶段：可以流式编码时边读边编码（见 streams_base64），否则一次读入整个文件
+ */
+[[nodiscard]] inline loaded_encode_input load_encode_input(const QString &file_path, const encode_options &options) {
+    if (!streams_base64(options)) {
+        return {read_whole_file(file_path)};
+    }
+    QFile file(file_path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        return {loaded_file{file_path}};
+    }
+    return {loaded_file{file_path, {}, true}, read_base64_payload(file)};
+}
+
+/**
+ * @brief 由流水线读取阶段读入的文件生成条码
+ */
+[[nodiscard]] inline result_data_entry encode_loaded(const loaded_encode_input &input, const encode_options &options) {
+    const auto &file = input.file;
+    if (!file.ok) {
+        return {file.path, (QCoreApplication::translate("convert", "无法打开文件: ") + file.path).toStdString()};
+    }
+    if (input.payload) {
+        return encode_payload(file.path, *input.payload, options);
+    }
+    return encode_data(file.path, file.data, options);
+}
+
+/**
+ * @brief 读取文件并生成条码，批量生成（界面与命令行）共用的工作函数
+ *
+ * @details 仅启用 Base64（不压缩）时按块读取文件并流式编码，不需要同时持有完整的原始数据与编码结果。
+ */
+[[nodiscard]] inline result_data_entry encode_file(const QString &file_path, const encode_options &options) {
+    return encode_loaded(load_encode_input(file_path, options), options);
+}
+
+/**
+ * @brief 图片到原始字节的解码参数
+ */
+struct decode_options {
+    bool use_base64 = true;                        /**< 识别出的文本是否需要 Base64 解码 */
+    int reduce_min_edge = default_reduce_min_edge; /**< 大图缩小识别的阈值，见 decode_encoded_image，0 表示不缩小 */
+    ZXing::BarcodeFormats formats{};               /**< 优先尝试的条码格式，见 QRcode_to_byte */
+    int tile_size = default_decode_tile_size;      /**< 大图分块识别的块大小，见 read_tiles，0 表示不分块 */
+    bool multi_symbol = false;                     /**< 一页多个标签：不做缩小识别，只按原分辨率识别，见 decode_encoded_image */
+};
+
+/**
+ * @brief 将识别到的一个条码还原为结果：分块内容留待重组，其余内容还原为原始字节
+ */
+[[nodiscard]] inline result_data_entry symbol_to_entry(const QString &source,
+                                                       const decoded_symbol &symbol,
+                                                       bool use_base64) {
+    result_data_entry res{source, std::monostate{}};
+    res.tier = symbol.tier;
+    res.barcode_format = symbol.format;
+    res.position = symbol.position;
+    try {
+        if (is_chunk(symbol.text)) {
+            if (auto fragment = parse_chunk(symbol.text)) {
+                res.data = std::move(*fragment);
+            } else {
+                res.set_error(QCoreApplication::translate("convert", "分块头部无效或分块校验失败"));
+            }
+            return res;
+        }
+        res.data = parse_payload(symbol.text, use_base64);
+    } catch (const std::exception &e) {
+        res.set_error(QCoreApplication::translate("convert", "解码失败:\n%1").arg(e.what()));
+    }
+    return res;
+}
+
+/**
+ * @brief 将识别到的全部条码还原为一个结果
+ * @return 只有一个条码时直接返回该条码的结果；有多个条码时结果的 parts 依次为各条码的结果（见 flatten_results），
+ *         保存时每个条码各写出一个文件
+ */
+[[nodiscard]] inline result_data_entry symbols_to_entry(const QString &source,
+                                                        const std::vector<decoded_symbol> &symbols,
+                                                        bool use_base64) {
+    if (symbols.empty()) {
+        return {source, QCoreApplication::translate("convert", "无法识别条码或条码格式不正确").toStdString()};
+    }
+    if (symbols.size() == 1) {
+        return symbol_to_entry(source, symbols.front(), use_base64);
+    }
+
+    spdlog::info("{} 中识别到 {} 个条码", source.toStdString(), symbols.size());
+    result_data_entry res{source, std::monostate{}};
+    const int count = static_cast<int>(symbols.size());
+    res.parts.reserve(symbols.size());
+    for (int i = 0; i < count; ++i) {
+        auto part = symbol_to_entry(source, symbols[i], use_base64);
+        part.symbol_index = i + 1;
+        part.symbol_count = count;
+        res.parts.push_back(std::move(part));
+    }
+    return res;
+}
+
+/**
+ * @brief 解析图像中的全部条码并还原为原始字节
+ * @param source 来源名称，用于结果与错误信息
+ * @param img 已加载的图像，为空表示加载失败
+ * @see symbols_to_entry
+ */
+[[nodiscard]] inline result_data_entry decode_image(const QString &source,
+                                                    const cv::Mat &img,
+                                                    const decode_options &options) {
+    if (img.empty()) {
+        spdlog::error("无法解码图片文件: {}", source.toStdString());
+        return {source, QCoreApplication::translate("convert", "无法加载图片文件: %1").arg(source).toStdString()};
+    }
+
+    std::vector<decoded_symbol> symbols;
+    try {
+        symbols = find_symbols(img, options.formats, options.tile_size);
+    } catch (const std::exception &e) {
+        return {source, QCoreApplication::translate("convert", "解码失败:\n%1").arg(e.what()).toStdString()};
+    }
+    return symbols_to_entry(source, symbols, options.use_base64);
+}
+
+/**
+ * @brief 解析压缩的图片数据（PNG/JPEG 等文件内容）中的条码
+ *
+ * @details 图片直接解码为灰度图，不生成随后又被丢弃的彩色通道。长边大于 2×reduce_min_edge 的大图先以缩小的分辨率识别，
+ *          找到条码即返回，条码模块足够大的扫描件只需解码与识别四分之一甚至更少的像素；找不到时才按原分辨率识别。
+ *          识别到的条码坐标换算回原图，结果的 position 总是原图中的坐标。
+ *          multi_symbol（一页多个标签）时跳过缩小识别：缩小后只能找到模块足够大的条码，找到一部分就返回会漏掉较小的条码。
+ */
+[[nodiscard]] inline result_data_entry decode_encoded_image(const QString &source,
+                                                            const uchar *data,
+                                                            std::size_t size,
+                                                            const decode_options &options) {
+    const int factor =
+        options.multi_symbol ? 1 : reduction_factor(encoded_image_size(data, size), options.reduce_min_edge);
+    if (factor > 1) {
+        std::vector<decoded_symbol> reduced;
+        try {
+            reduced = find_symbols(decode_grayscale(data, size, factor), options.formats, options.tile_size);
+        } catch (const std::exception &e) {
+            spdlog::debug("以 1/{} 分辨率识别出错: {}", factor, e.what());
+        }
+        if (!reduced.empty()) {
+            spdlog::debug("以 1/{} 分辨率识别成功: {}", factor, source.toStdString());
+            scale_symbols(reduced, factor);
+            return symbols_to_entry(source, reduced, options.use_base64);
+        }
+        spdlog::debug("以 1/{} 分辨率未识别到条码，按原分辨率重试: {}", factor, source.toStdString());
+    }
+    return decode_image(source, decode_grayscale(data, size), options);
+}
+
+/**
+ * @brief 解码参数的指纹，解码缓存按指纹区分，参数改变时旧结果失效
+ */
+[[nodiscard]] inline QByteArray decode_fingerprint(const decode_options &options) {
+    // 序列化格式或识别逻辑改变时递增版本，使旧的缓存失效（2：缩小识别的坐标换算回原图；3：分块头部以 \0L2Q| 开始）
+    constexpr int version = 3;
+    const auto text = fmt::format("v{}|base64={}|reduce={}|formats={}|tile={}|multi={}",
+                                  version,
+                                  options.use_base64,
+                                  options.reduce_min_edge,
+                                  ZXing::ToString(options.formats),
+                                  options.tile_size,
+                                  options.multi_symbol);
+    return QCryptographicHash::hash(QByteArray::fromStdString(text), QCryptographicHash::Sha1);
+}
+
+namespace detail {
+
+inline void write_decoded(QDataStream &out, const result_data_entry &entry) {
+    if (const auto *data = std::get_if<QByteArray>(&entry.data)) {
+        out << quint8(1) << *data;
+    } else if (const auto *fragment = std::get_if<chunk_fragment>(&entry.data)) {
+        out << quint8(2) << quint32(fragment->file_id) << qint32(fragment->index) << qint32(fragment->count)
+            << QByteArray::fromStdString(fragment->data);
+    } else {
+        out << quint8(0);
+    }
+    out << quint8(entry.tier) << qint32(entry.barcode_format);
+    for (const auto &p : entry.position) {
+        out << qint32(p.x) << qint32(p.y);
+    }
+    out << qint32(entry.symbol_index) << qint32(entry.symbol_count) << quint32(entry.parts.size());
+    for (const auto &part : entry.parts) {
+        write_decoded(out, part);
+    }
+}
+
+[[nodiscard]] inline bool read_decoded(QDataStream &in, result_data_entry &entry) {
+    quint8 kind = 0;
+    in >> kind;
+    if (kind == 1) {
+        QByteArray data;
+        in >> data;
+        entry.data = std::move(data);
+    } else if (kind == 2) {
+        quint32 file_id = 0;
+        qint32 index = 0;
+        qint32 count = 0;
+        QByteArray data;
+        in >> file_id >> index >> count >> data;
+        if (count < 1 || count > max_chunk_count || index < 1 || index > count) {
+            return false;
+        }
+        entry.data = chunk_fragment{file_id, index, count, data.toStdString()};
+    }
+
+    quint8 tier = 0;
+    qint32 format = 0;
+    in >> tier >> format;
+    entry.tier = static_cast<decode_tier>(tier);
+    entry.barcode_format = static_cast<ZXing::BarcodeFormat>(format);
+    for (auto &p : entry.position) {
+        qint32 x = 0;
+        qint32 y = 0;
+        in >> x >> y;
+        p = {x, y};
+    }
+
+    qint32 symbol_index = 0;
+    qint32 symbol_count = 0;
+    quint32 parts = 0;
+    in >> symbol_index >> symbol_count >> parts;
+    entry.symbol_index = symbol_index;
+    entry.symbol_count = symbol_count;
+    if (in.status() != QDataStream::Ok || parts > 4096) {
+        return false;
+    }
+    entry.parts.resize(parts);
+    for (auto &part : entry.parts) {
+        part.source_file_name = entry.source_file_name;
+        if (!read_decoded(in, part)) {
+            return false;
+        }
+    }
+    return in.status() == QDataStream::Ok;
+}
+
+} // namespace detail
+
+/**
+ * @brief 序列化解码结果，写入 decode_cache
+ */
+[[nodiscard]] inline QByteArray serialize_decoded(const result_data_entry &entry) {
+    QByteArray blob;
+    QDataStream out(&blob, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_5_12);
+    detail::write_decoded(out, entry);
+    return blob;
+}
+
+/**
+ * @brief 读回 serialize_decoded 写入的解码结果
+ * @return 数据损坏时返回 std::nullopt
+ */
+[[nodiscard]] inline std::optional<result_data_entry> deserialize_decoded(const QByteArray &blob,
+                                                                          const QString &source) {
+    QDataStream in(blob);
+    in.setVersion(QDataStream::Qt_5_12);
+    result_data_entry entry{source, std::monostate{}};
+    if (!detail::read_decoded(in, entry) || !in.atEnd()) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+/**
+ * @brief 结果是否可以缓存：只缓存完全成功的结果，识别失败的图片下次仍重新识别
+ */
+[[nodiscard]] inline bool is_cacheable(const result_data_entry &entry) {
+    if (!entry.parts.empty()) {
+        return std::ranges::all_of(entry.parts, [](const result_data_entry &part) { return bool(part); });
+    }
+    return bool(entry);
+}
+
+/**
+ * @brief 解码已读入内存（或已映射）的图片文件
+ *
+ * @details 启用 decode_cache 时，先按图片内容的 SHA-1 与解码参数查找缓存，同一份图片再次解码时直接读回结果。
+ */
+[[nodiscard]] inline result_data_entry decode_file_data(const QString &file_path,
+                                                        const uchar *data,
+                                                        std::size_t size,
+                                                        const decode_options &options) {
+    auto &cache = decode_cache::instance();
+    QByteArray fingerprint;
+    QByteArray key;
+    if (cache.enabled() && size > 0) {
+        fingerprint = decode_fingerprint(options);
+        key = QCryptographicHash::hash(
+            QByteArray::fromRawData(reinterpret_cast<const char *>(data), static_cast<int>(size)),
+            QCryptographicHash::Sha1);
+        if (const auto blob = cache.find(fingerprint, key)) {
+            if (auto cached = deserialize_decoded(*blob, file_path)) {
+                return *std::move(cached);
+            }
+            spdlog::warn("解码缓存已损坏，重新解码: {}", file_path.toStdString());
+        }
+    }
+
+    auto res = decode_encoded_image(file_path, data, size, options);
+    if (!key.isEmpty() && is_cacheable(res)) {
+        cache.insert(fingerprint, key, serialize_decoded(res));
+    }
+    return res;
+}
+
+/**
+ * @brief 读取图片文件并解码，文件以内存映射打开
+ */
+[[nodiscard]] inline result_data_entry decode_file(const QString &file_path, const decode_options &options) {
+    const mapped_image_file file(file_path);
+    return decode_file_data(file_path, file.data(), file.size(), options);
+}
+
+/**
+ * @brief 一个解码任务：一个图片文件，或多页 TIFF 中的一页
+ */
+struct decode_task {
+    QString path;
+    int page = -1; /**< 页序号（从0开始），-1 表示整个文件 */
+
+    /**
+     * @brief 结果中显示的来源：多页文件的某一页为 `file.tif#p3`（页码从1开始）
+     */
+    [[nodiscard]] QString source_name() const {
+        return page < 0 ? path : QString("%1#p%2").arg(path).arg(page + 1);
+    }
+};
+
+/**
+ * @brief 多页图片文件的页数，单页或不是 TIFF 时返回 1
+ */
+[[nodiscard]] inline int image_page_count(const QString &file_path) {
+    const QString suffix = QFileInfo(file_path).suffix().toLower();
+    if (suffix != "tif" && suffix != "tiff") {
+        return 1;
+    }
+    try {
+        return std::max(static_cast<int>(cv::imcount(QFile::encodeName(file_path).toStdString())), 1);
+    } catch (const cv::Exception &e) {
+        spdlog::warn("无法读取 TIFF 页数，按单页处理: {}: {}", file_path.toStdString(), e.what());
+        return 1;
+    }
+}
+
+/**
+ * @brief 把待解码的文件展开为任务：多页 TIFF 的每一页是一个任务，线程池中各页并行解码
+ */
+[[nodiscard]] inline QList<decode_task> expand_decode_tasks(const QStringList &file_paths) {
+    QList<decode_task> tasks;
+    for (const auto &path : file_paths) {
+        const int pages = image_page_count(path);
+        if (pages <= 1) {
+            tasks.append({path});
+            continue;
+        }
+        spdlog::info("多页图片 {}: {} 页", path.toStdString(), pages);
+        for (int page = 0; page < pages; ++page) {
+            tasks.append({path, page});
+        }
+    }
+    return tasks;
+}
+
+/**
+ * @brief 解码多页图片中的一页
+ * @param page 页序号（从0开始）
+ *
+ * @details 只解码这一页，各页由不同的线程同时读取。页没有单独的内容哈希，不经过 decode_cache。
+ */
+[[nodiscard]] inline result_data_entry decode_page(const QString &file_path, int page, const decode_options &options) {
+    const decode_task task{file_path, page};
+    std::vector<cv::Mat> mats;
+    try {
+        const stage_timer timer(batch_stage::image_decode);
+        cv::imreadmulti(QFile::encodeName(file_path).toStdString(), mats, page, 1, cv::IMREAD_GRAYSCALE);
+    } catch (const cv::Exception &e) {
+        spdlog::warn("读取第 {} 页失败: {}: {}", page + 1, file_path.toStdString(), e.what());
+    }
+
+    auto res = decode_image(task.source_name(), mats.empty() ? cv::Mat{} : mats.front(), options);
+    res.page = page + 1;
+    for (auto &part : res.parts) {
+        part.page = page + 1;
+    }
+    return res;
+}
+
+/**
+ * @brief 执行一个解码任务，批量解码（界面与命令行）共用的工作函数
+ */
+[[nodiscard]] inline result_data_entry decode_task_file(const decode_task &task, const decode_options &options) {
+    return task.page < 0 ? decode_file(task.path, options) : decode_page(task.path, task.page, options);
+}
+
+/**
+ * @brief 流水线读取阶段读入的解码任务：整个文件读入内存；多页文件的一页在解码时才读取这一页
+ */
+struct loaded_decode_task {
+    decode_task task;
+    loaded_file file;
+};
+
+[[nodiscard]] inline loaded_decode_task load_decode_task(const decode_task &task) {
+    return {task, task.page < 0 ? read_whole_file(task.path) : loaded_file{task.path}};
+}
+
+/**
+ * @brief 解码流水线读取阶段读入的任务，文件读取失败时结果为错误信息
+ */
+[[nodiscard]] inline result_data_entry decode_loaded(const loaded_decode_task &loaded, const decode_options &options) {
+    const auto &[task, file] = loaded;
+    if (task.page >= 0) {
+        return decode_page(task.path, task.page, options);
+    }
+    return decode_file_data(task.path,
+                            reinterpret_cast<const uchar *>(file.data.constData()),
+                            static_cast<std::size_t>(file.data.size()),
+                            options);
+}
+
+/**
+ * @brief 统计并输出一批解码结果中各层级的识别数量，用于调整解码级联
+ * @return 显示在批处理汇总中的一行，没有解码结果时为空
+ */
+inline QString log_decode_tiers(const std::vector<result_data_entry> &results) {
+    std::map<decode_tier, int> counts;
+    for (const auto &entry : results) {
+        if (entry.tier != decode_tier::none) {
+            ++counts[entry.tier];
+        }
+    }
+    if (counts.empty()) {
+        return {};
+    }
+    spdlog::info("解码层级: pure {}, hinted {}, full {}",
+                 counts[decode_tier::pure],
+                 counts[decode_tier::hinted],
+                 counts[decode_tier::full]);
+    return QCoreApplication::translate("convert", "识别层级: pure %1, hinted %2, full %3")
+        .arg(counts[decode_tier::pure])
+        .arg(counts[decode_tier::hinted])
+        .arg(counts[decode_tier::full]);
+}
+
+/**
+ * @brief 将带有 parts 的结果展开为各个子结果，其余结果保持原有顺序
+ */
+inline void flatten_results(std::vector<result_data_entry> &results) {
+    if (std::ranges::all_of(results, [](const result_data_entry &entry) { return entry.parts.empty(); })) {
+        return;
+    }
+
+    std::vector<result_data_entry> flat;
+    flat.reserve(results.size());
+    for (auto &entry : results) {
+        if (entry.parts.empty()) {
+            flat.push_back(std::move(entry));
+        } else {
+            std::ranges::move(entry.parts, std::back_inserter(flat));
+        }
+    }
+    results = std::move(flat);
+}
+
+/**
+ * @brief 去掉分块图片文件名中的 _0001 序号，得到原始文件对应的名称
+ */
+[[nodiscard]] inline QString strip_chunk_suffix(const QString &file_name) {
+    static const QRegularExpression suffix(R"(^(.*)_\d{4,}$)");
+
+    const QFileInfo info(file_name);
+    const auto match = suffix.match(info.completeBaseName());
+    if (!match.hasMatch()) {
+        return file_name;
+    }
+    const QString name = info.suffix().isEmpty() ? match.captured(1) : match.captured(1) + "." + info.suffix();
+    return info.path() == "." ? name : info.path() + "/" + name;
+}
+
+/**
+ * @brief 将解码结果中的分块按文件ID与总数分组并重组为完整文件
+ * @param results 解码结果，分块会被替换为重组后的结果（位于该文件第一个分块的位置）
+ * @param use_base64 重组后的内容是否需要 Base64 解码
+ *
+ * @details 同一组中序号重复的分块（内容相同的两个文件，或同一张分块图片扫描了两次）依次分配到不同的副本，
+ *          每个副本各自重组为一个结果，不会被后来的分块覆盖。分块缺失或整体校验失败时，该副本的结果为错误信息。
+ */
+inline void reassemble_chunks(std::vector<result_data_entry> &results, bool use_base64) {
+    std::map<std::pair<std::uint32_t, int>, std::vector<std::size_t>> groups;
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (const auto *fragment = std::get_if<chunk_fragment>(&results[i].data)) {
+            groups[{fragment->file_id, fragment->count}].push_back(i);
+        }
+    }
+    if (groups.empty()) {
+        return;
+    }
+
+    std::unordered_map<std::size_t, result_data_entry> assembled;
+    for (const auto &[key, indices] : groups) {
+        const auto [file_id, count] = key;
+
+        // 按序号收集已收到的分块，不按头部中的总数预先分配；序号已出现过的分块放入下一个副本
+        std::vector<std::map<int, std::size_t>> copies;
+        for (const auto index : indices) {
+            const int number = std::get<chunk_fragment>(results[index].data).index;
+            const auto copy = std::ranges::find_if(copies, [&](const auto &c) { return !c.contains(number); });
+            if (copy == copies.end()) {
+                copies.push_back({{number, index}});
+            } else {
+                copy->emplace(number, index);
+            }
+        }
+        if (copies.size() > 1) {
+            spdlog::info("文件 {:08x} 的分块重复出现，重组为 {} 个副本", file_id, copies.size());
+        }
+
+        for (const auto &ordered : copies) {
+            // 副本中位置最靠前的分块，其来源用于命名，结果也放在它的位置
+            std::size_t first = results.size();
+            for (const auto &[number, index] : ordered) {
+                first = std::min(first, index);
+            }
+            result_data_entry entry{strip_chunk_suffix(results[first].source_file_name), std::monostate{}};
+            if (const auto missing = count - static_cast<int>(ordered.size()); missing > 0) {
+                entry.set_error(QCoreApplication::translate("convert", "缺少 %1/%2 个分块").arg(missing).arg(count));
+            } else {
+                std::string payload;
+                for (const auto &[number, index] : ordered) {
+                    payload += std::get<chunk_fragment>(results[index].data).data;
+                }
+                if (crc32(payload) != file_id) {
+                    entry.set_error(QCoreApplication::translate("convert", "重组后的文件校验失败"));
+                } else {
+                    try {
+                        entry.data = parse_payload(payload, use_base64);
+                    } catch (const std::exception &e) { entry.set_error(e.what()); }
+                }
+            }
+            assembled.emplace(first, std::move(entry));
+        }
+    }
+
+    std::vector<result_data_entry> merged;
+    merged.reserve(results.size());
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        if (auto it = assembled.find(i); it != assembled.end()) {
+            merged.push_back(std::move(it->second));
+        } else if (!std::holds_alternative<chunk_fragment>(results[i].data)) {
+            merged.push_back(std::move(results[i]));
+        }
+    }
+    results = std::move(merged);
+}
+
+/**
+ * @brief 把单个结果编码为文件内容：条码按扩展名编码为位图或矢量文件（见 encode_symbol），解码得到的内容原样写出
+ * @param level PNG 与 PDF 内容流的 zlib 压缩级别（0~9）
+ * @return 没有可保存的内容或编码失败时返回 std::nullopt
+ */
+[[nodiscard]] inline std::optional<QByteArray> encode_entry(const result_data_entry &entry,
+                                                            const QString &path,
+                                                            int level = 6) {
+    if (const auto *img = std::get_if<QImage>(&entry.data)) {
+        QByteArray data = encode_symbol(*img, entry.vector, path, level);
+        return data.isEmpty() ? std::nullopt : std::optional<QByteArray>(std::move(data));
+    }
+    if (const auto *data = std::get_if<QByteArray>(&entry.data)) {
+        return *data;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief 保存单个结果，见 encode_entry
+ * @return 没有可保存的内容或写入失败时返回 false
+ */
+[[nodiscard]] inline bool save_entry(const result_data_entry &entry, const QString &path, int level = 6) {
+    const auto data = encode_entry(entry, path, level);
+    return data && write_file(path, *data);
+}
+
+/**
+ * @brief 流式批处理保留的缩略图数量上限，超出后只保留元数据，内存占用与批量大小无关
+ */
+inline constexpr int default_stream_thumbnails = 512;
+
+/**
+ * @brief 流式批处理的设置
+ */
+struct stream_options {
+    QString output_dir;                           /**< 结果写入的目录 */
+    QString image_suffix = "png";                 /**< 条码的保存格式（png、svg 或 pdf） */
+    int level = 6;                                /**< PNG 与 PDF 内容流的 zlib 压缩级别（0~9） */
+    int thumbnail_edge = 128;                     /**< 缩略图的最大边长 */
+    int preview_bytes = 256;                      /**< 解码内容保留的预览字节数 */
+    std::shared_ptr<std::atomic<int>> thumbnails; /**< 剩余可保留的缩略图数，为空表示不限 */
+};
+
+/**
+ * @brief 流式批处理的计算阶段：把结果编码为要写出的文件，结果本身只保留缩略图与元数据
+ * @return 结果的 saved_path 为将要写入的文件，条码替换为灰度缩略图（缩略图数量用完后为空图），
+ *         解码内容只保留开头的预览；编码失败时结果为错误信息
+ *
+ * @details 在工作线程中调用，完整的图片与内容编码后立即释放。文件由写入阶段写出，写入失败时调用 mark_unsaved。
+ *          错误与待重组的分块原样返回，分块由调用方重组后再写入。
+ */
+[[nodiscard]] inline staged_result<result_data_entry> prepare_stream(result_data_entry entry,
+                                                                     const stream_options &options) {
+    staged_result<result_data_entry> staged;
+    for (auto &part : entry.parts) {
+        auto sub = prepare_stream(std::move(part), options);
+        part = std::move(sub.result);
+        std::ranges::move(sub.outputs, std::back_inserter(staged.outputs));
+    }
+    if (!std::holds_alternative<QImage>(entry.data) && !std::holds_alternative<QByteArray>(entry.data)) {
+        staged.result = std::move(entry);
+        return staged;
+    }
+
+    const QString path = QDir(options.output_dir).filePath(entry.get_default_target_name(options.image_suffix));
+    auto data = encode_entry(entry, path, options.level);
+    if (!data) {
+        spdlog::error("编码失败: {}", path.toStdString());
+        entry.set_error(QCoreApplication::translate("convert", "写入失败: %1").arg(path));
+        staged.result = std::move(entry);
+        return staged;
+    }
+    staged.outputs.push_back({path, *std::move(data)});
+    entry.saved_path = path;
+    entry.vector.reset();
+
+    if (auto *img = std::get_if<QImage>(&entry.data)) {
+        const int edge = options.thumbnail_edge;
+        if (options.thumbnails && options.thumbnails->fetch_sub(1) <= 0) {
+            *img = QImage{};
+        } else if (img->width() > edge || img->height() > edge) {
+            const stage_timer timer(batch_stage::resize);
+            *img = img->scaled(edge, edge, Qt::KeepAspectRatio, Qt::SmoothTransformation)
+                       .convertToFormat(QImage::Format_Grayscale8);
+        }
+    } else if (auto *bytes = std::get_if<QByteArray>(&entry.data)) {
+        // left() 复制出预览，完整内容随原数组释放
+        *bytes = bytes->left(options.preview_bytes);
+    }
+    staged.result = std::move(entry);
+    return staged;
+}
+
+/**
+ * @brief 文件没有写成功：把对应的结果（或子结果）改为错误信息
+ */
+inline void mark_unsaved(result_data_entry &entry, const QString &path) {
+    if (entry.saved_path == path) {
+        entry.saved_path.clear();
+        entry.set_error(QCoreApplication::translate("convert", "写入失败: %1").arg(path));
+    }
+    for (auto &part : entry.parts) {
+        mark_unsaved(part, path);
+    }
+}
+
+/**
+ * @brief 流式批处理：结果一生成就写入输出目录，返回只保留缩略图与元数据的结果，见 prepare_stream
+ */
+[[nodiscard]] inline result_data_entry stream_result(result_data_entry entry, const stream_options &options) {
+    auto staged = prepare_stream(std::move(entry), options);
+    for (const auto &output : staged.outputs) {
+        if (!write_file(output.path, output.data)) {
+            spdlog::error("写入失败: {}", output.path.toStdString());
+            mark_unsaved(staged.result, output.path);
+        }
+    }
+    return std::move(staged.result);
+}
+
+/**
+ * @brief 批处理流水线计算阶段的结尾：启用流式保存时编码要写出的文件（见 prepare_stream），否则原样返回结果
+ */
+[[nodiscard]] inline staged_result<result_data_entry> stage_result(result_data_entry entry,
+                                                                   const std::optional<stream_options> &stream) {
+    if (stream) {
+        return prepare_stream(std::move(entry), *stream);
+    }
+    return {std::move(entry)};
 }
 
 } // namespace convert
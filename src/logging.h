@@ -2,6 +2,7 @@
 #include <filesystem>
 #include <spdlog/sinks/daily_file_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
+#include <spdlog/sinks/stdout_sinks.h>
 #include <spdlog/spdlog.h>
 
 namespace Logging {
@@ -31,4 +32,19 @@ inline void setupLogging() {
     spdlog::flush_on(spdlog::level::debug);
 }
 
+/**
+ * @brief 初始化命令行工具的日志系统
+ *
+ * 日志只输出到 stderr，stdout 留给机器可读的结果输出。
+ * @param level 日志级别
+ */
+inline void setupCliLogging(spdlog::level::level_enum level) {
+    auto stderr_sink = std::make_shared<spdlog::sinks::stderr_sink_mt>();
+    stderr_sink->set_pattern("[%Y-%m-%d %H:%M:%S] [thread %t] [%l] %v");
+
+    auto logger = std::make_shared<spdlog::logger>("cli", stderr_sink);
+    logger->set_level(level);
+    spdlog::set_default_logger(logger);
+}
+
 } // namespace Logging
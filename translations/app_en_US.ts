@@ -383,6 +383,108 @@ or enter content</translation>
         <source>语言</source>
         <translation>Language</translation>
     </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="148"/>
+        <source>分块生成</source>
+        <translation>Chunked Generation</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="144"/>
+        <source>二进制模式</source>
+        <translation>Binary Mode</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="149"/>
+        <source>压缩</source>
+        <translation>Compression</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="172"/>
+        <source>保存格式</source>
+        <translation>Save Format</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="176"/>
+        <source>SVG（矢量）</source>
+        <translation>SVG (vector)</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="177"/>
+        <source>PDF（矢量）</source>
+        <translation>PDF (vector)</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="164"/>
+        <source>边处理边保存</source>
+        <translation>Save While Processing</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="1103"/>
+        <source>已保存:
+%1</source>
+        <translation>Saved:
+%1</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="255"/>
+        <source>暂停</source>
+        <translation>Pause</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="406"/>
+        <source>继续</source>
+        <translation>Resume</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="258"/>
+        <source>取消</source>
+        <translation>Cancel</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="844"/>
+        <source>
+
+保存已取消，其余文件没有保存。</source>
+        <translation>
+
+Saving was canceled; the remaining files were not saved.</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="347"/>
+        <source>十六进制</source>
+        <translation>Hex</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="349"/>
+        <source>文本</source>
+        <translation>Text</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="1136"/>
+        <source>%1，正在分析内容…</source>
+        <translation>%1, analyzing content…</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="1138"/>
+        <source>%1，二进制内容</source>
+        <translation>%1, binary content</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="1140"/>
+        <source>%1，UTF-8 文本</source>
+        <translation>%1, UTF-8 text</translation>
+    </message>
+    <message>
+        <location filename="../src/BarcodeWidget.cpp" line="946"/>
+        <source>
+
+[耗时]:
+</source>
+        <translation>
+
+[Timing]:
+</translation>
+    </message>
 </context>
 <context>
     <name>CameraWidget</name>
@@ -748,4 +850,79 @@ Time: %3
         <translation>The message has been exported to: </translation>
     </message>
 </context>
+<context>
+    <name>convert</name>
+    <message>
+        <location filename="../src/convert.h" line="210"/>
+        <source>生成图片失败</source>
+        <translation>Failed to generate image</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="224"/>
+        <source>无法打开文件: </source>
+        <translation>Unable to open the file: </translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="244"/>
+        <source>无法加载图片文件: %1</source>
+        <translation>Unable to load image file: %1</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="246"/>
+        <source>无法识别条码或条码格式不正确</source>
+        <translation>Unable to recognise the barcode or the barcode format is incorrect</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="250"/>
+        <source>解码失败:
+%1</source>
+        <translation>Decoding failed:
+%1</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="351"/>
+        <source>分块头部无效或分块校验失败</source>
+        <translation>Invalid chunk header or chunk checksum mismatch</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="440"/>
+        <source>缺少 %1/%2 个分块</source>
+        <translation>Missing %1 of %2 chunks</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="451"/>
+        <source>重组后的文件校验失败</source>
+        <translation>Checksum of the reassembled file does not match</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="256"/>
+        <source>无法识别的内容头部，请使用新版本解码</source>
+        <translation>Unrecognized payload header, please decode with a newer version</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="252"/>
+        <source>解压失败，数据可能已损坏</source>
+        <translation>Decompression failed, the data may be corrupted</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="1230"/>
+        <source>写入失败: %1</source>
+        <translation>Failed to write: %1</translation>
+    </message>
+    <message>
+        <location filename="../src/codec/timing.h" line="96"/>
+        <source>%1 个文件，耗时 %2 s，%3 个/s，%4 MB/s</source>
+        <translation>%1 files in %2 s, %3 files/s, %4 MB/s</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="700"/>
+        <source>分块数超过上限 %1，请增大分块大小</source>
+        <translation>Too many chunks (limit %1); increase the chunk size</translation>
+    </message>
+    <message>
+        <location filename="../src/convert.h" line="1242"/>
+        <source>识别层级: pure %1, hinted %2, full %3</source>
+        <translation>Decode tiers: pure %1, hinted %2, full %3</translation>
+    </message>
+</context>
 </TS>